@@ -0,0 +1,287 @@
+#include "Kernels.h"
+#include "Shapes.h"
+#include "Parsing.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <numbers>
+#include <random>
+#include <cmath>
+
+namespace {
+
+	struct Options {
+		std::vector<size_t> sizes{ 3, 4, 5, 6, 8, 12, 16, 32, 64, 128, 256 };
+		size_t queryCount = 4096;
+		double milliseconds = 100.0;
+		uint32_t seed = 1;
+	};
+
+	bool ParseOptions(int argc, char* argv[], Options& options) {
+		for (int argument = 1; argument + 1 < argc; argument += 2) {
+			const std::string_view option = argv[argument], value = argv[argument + 1];
+			bool valid = false;
+			if (option == "--sizes") {
+				valid = ParseList(value, options.sizes) && std::ranges::all_of(options.sizes, [](size_t size) { return size >= 3; });
+			}
+			else if (option == "--queries") {
+				valid = ParseNumber(value, options.queryCount) && options.queryCount > 0;
+			}
+			else if (option == "--time-ms") {
+				valid = ParseNumber(value, options.milliseconds) && options.milliseconds > 0.0;
+			}
+			else if (option == "--seed") {
+				valid = ParseNumber(value, options.seed);
+			}
+			if (!valid) {
+				return false;
+			}
+		}
+		return argc % 2 == 1;
+	}
+
+	// The standard distributions may differ between standard libraries, so numbers are drawn straight from the engine,
+	// so that a seed measures the same queries everywhere
+	float Uniform(std::mt19937& engine, float min, float max) noexcept {
+		return min + (max - min) * static_cast<float>(engine() >> 8) * 0x1.0p-24f;
+	}
+
+	Geometry::Vector2<float> AtAngle(float angle, float radius) noexcept {
+		return Geometry::Vector2<float>{ std::cos(angle), std::sin(angle) } * radius;
+	}
+
+	// The regular polygon of vertexCount vertices on the unit circle, turned by rotation
+	Geometry::Polygon RegularPolygon(size_t vertexCount, float rotation) {
+		Geometry::Polygon polygon;
+		for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
+			polygon.vertices.push_back(AtAngle(rotation + 2.0f * std::numbers::pi_v<float> * static_cast<float>(vertex) / static_cast<float>(vertexCount), 1.0f));
+		}
+		return polygon;
+	}
+
+	// Queries cycle through a few differently turned polygons of each size, so that no two queries in a row are alike
+	constexpr size_t POLYGON_VARIANTS = 16;
+
+	// What a kernel is called with. Which of the points it uses, and as what, is up to the kernel.
+	struct Query {
+		size_t polygon = 0;
+		Geometry::Vector2<float> a{}, b{}, c{}, d{};
+	};
+
+	// Makes a query about polygon, or about nothing in particular for kernels that take no polygon
+	using QueryMaker = std::function<Query(std::mt19937&, const Geometry::Polygon&)>;
+
+	struct Case {
+		const char* name;
+		QueryMaker make;
+	};
+
+	// Calls kernel with every query, over and over until at least minimum has passed, and returns the nanoseconds per
+	// call and the fraction of calls that returned true. Counting what kernel returns also keeps it from being optimized out.
+	struct Measurement {
+		double nanoseconds;
+		double hitRate;
+	};
+	template <typename Kernel>
+	Measurement Measure(const std::vector<Query>& queries, Kernel kernel, std::chrono::duration<double> minimum) {
+		for (size_t passes = 1;; passes *= 2) {
+			size_t hits = 0;
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t pass = 0; pass < passes; ++pass) {
+				for (const Query& query : queries) {
+					hits += kernel(query) ? 1 : 0;
+				}
+			}
+			const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			if (elapsed >= minimum) {
+				const double calls = static_cast<double>(passes * queries.size());
+				return { std::chrono::duration<double, std::nano>(elapsed).count() / calls, static_cast<double>(hits) / calls };
+			}
+		}
+	}
+
+	// Measures kernel on each case, with polygons of vertexCount vertices, or none if vertexCount is what the kernel
+	// always takes rather than a polygon size
+	template <typename Kernel>
+	void MeasureCases(const char* kernelName, const std::vector<Case>& cases, size_t vertexCount,
+		const std::vector<Geometry::Polygon>& polygons, Kernel kernel, const Options& options) {
+		for (const Case& queryCase : cases) {
+			std::mt19937 engine(options.seed);
+			std::vector<Query> queries(options.queryCount);
+			for (size_t index = 0; index < queries.size(); ++index) {
+				const size_t polygon = polygons.empty() ? 0 : index % polygons.size();
+				queries[index] = queryCase.make(engine, polygons.empty() ? Geometry::Polygon{} : polygons[polygon]);
+				queries[index].polygon = polygon;
+			}
+			const Measurement measurement = Measure(queries, kernel, std::chrono::duration<double, std::milli>(options.milliseconds));
+			const double callsPerMicrosecond = 1000.0 / measurement.nanoseconds;
+			std::printf("%s,%s,%zu,%zu,%.2f,%.2f,%.2f,%.3f\n", kernelName, queryCase.name, vertexCount, options.queryCount,
+				measurement.nanoseconds, callsPerMicrosecond, callsPerMicrosecond * static_cast<double>(vertexCount), measurement.hitRate);
+			std::fflush(stdout);
+		}
+	}
+
+	// A random vertex of polygon, and the one after it
+	std::pair<Geometry::Vector2<float>, Geometry::Vector2<float>> RandomEdge(std::mt19937& engine, const Geometry::Polygon& polygon) {
+		const size_t vertex = engine() % polygon.vertices.size();
+		return { polygon.vertices[vertex], polygon.vertices[(vertex + 1) % polygon.vertices.size()] };
+	}
+
+	float RandomAngle(std::mt19937& engine) noexcept {
+		return Uniform(engine, 0.0f, 2.0f * std::numbers::pi_v<float>);
+	}
+
+	// The polygons are on the unit circle, and a triangle's inscribed circle has a radius of one half, so anything within
+	// that is inside every polygon, and anything beyond one is outside every polygon
+
+	// Lines as a and b, against polygons
+	const std::vector<Case> LINE_CASES = {
+		{ "hit", [](std::mt19937& engine, const Geometry::Polygon&) {
+			// Nearly through the center, from one side to the other
+			const float angle = RandomAngle(engine);
+			return Query{ 0, AtAngle(angle, 3.0f), AtAngle(angle + std::numbers::pi_v<float> + Uniform(engine, -0.2f, 0.2f), 3.0f) };
+		} },
+		{ "miss", [](std::mt19937& engine, const Geometry::Polygon&) {
+			// Pointing straight at the polygon from just outside it, so that only an edge tells them apart
+			const float angle = RandomAngle(engine);
+			return Query{ 0, AtAngle(angle, 1.05f), AtAngle(angle, 3.0f) };
+		} },
+		{ "far", [](std::mt19937& engine, const Geometry::Polygon&) {
+			// Nowhere near the polygon, or its bounding box
+			const float angle = RandomAngle(engine);
+			return Query{ 0, AtAngle(angle, 3.0f), AtAngle(angle + 0.5f, 3.0f) };
+		} },
+		{ "vertex", [](std::mt19937& engine, const Geometry::Polygon& polygon) {
+			// Out of a vertex, away from the polygon, which touches but does not intersect
+			const Geometry::Vector2<float> vertex = RandomEdge(engine, polygon).first;
+			return Query{ 0, vertex, vertex * 3.0f };
+		} },
+		{ "edge", [](std::mt19937& engine, const Geometry::Polygon& polygon) {
+			// Along an edge, which is what the visibility graph asks about polygons most
+			const auto [from, to] = RandomEdge(engine, polygon);
+			return Query{ 0, from, to };
+		} }
+	};
+
+	// Points as a, against polygons
+	const std::vector<Case> POINT_CASES = {
+		{ "hit", [](std::mt19937& engine, const Geometry::Polygon&) {
+			const float angle = RandomAngle(engine);
+			return Query{ 0, AtAngle(angle, Uniform(engine, 0.0f, 0.45f)) };
+		} },
+		{ "miss", [](std::mt19937& engine, const Geometry::Polygon&) {
+			const float angle = RandomAngle(engine);
+			return Query{ 0, AtAngle(angle, Uniform(engine, 1.05f, 3.0f)) };
+		} },
+		{ "edge", [](std::mt19937& engine, const Geometry::Polygon& polygon) {
+			const auto [from, to] = RandomEdge(engine, polygon);
+			return Query{ 0, (from + to) * 0.5f };
+		} },
+		{ "vertex", [](std::mt19937& engine, const Geometry::Polygon& polygon) {
+			return Query{ 0, RandomEdge(engine, polygon).first };
+		} }
+	};
+
+	// View points as a, which are always outside the polygon
+	const std::vector<Case> VIEW_CASES = {
+		{ "far", [](std::mt19937& engine, const Geometry::Polygon&) {
+			const float angle = RandomAngle(engine);
+			return Query{ 0, AtAngle(angle, Uniform(engine, 5.0f, 20.0f)) };
+		} },
+		{ "near", [](std::mt19937& engine, const Geometry::Polygon&) {
+			const float angle = RandomAngle(engine);
+			return Query{ 0, AtAngle(angle, Uniform(engine, 1.05f, 1.5f)) };
+		} },
+		{ "edge", [](std::mt19937& engine, const Geometry::Polygon& polygon) {
+			// In line with an edge, so that both its vertices are at the same angle
+			const auto [from, to] = RandomEdge(engine, polygon);
+			return Query{ 0, from + (from - to) * Uniform(engine, 0.5f, 2.0f) };
+		} }
+	};
+
+	// Pairs of lines, a to b and c to d
+	const std::vector<Case> LINE_PAIR_CASES = {
+		{ "hit", [](std::mt19937& engine, const Geometry::Polygon&) {
+			const float angle = RandomAngle(engine);
+			const float across = angle + Uniform(engine, 0.5f, 2.5f);
+			return Query{ 0, AtAngle(angle, -1.0f), AtAngle(angle, 1.0f), AtAngle(across, -1.0f), AtAngle(across, 1.0f) };
+		} },
+		{ "miss", [](std::mt19937& engine, const Geometry::Polygon&) {
+			const float angle = RandomAngle(engine);
+			const Geometry::Vector2<float> offset = AtAngle(angle + 0.5f * std::numbers::pi_v<float>, Uniform(engine, 0.1f, 1.0f));
+			return Query{ 0, AtAngle(angle, -1.0f), AtAngle(angle, 1.0f), AtAngle(angle, -1.0f) + offset, AtAngle(angle, 1.0f) + offset };
+		} },
+		{ "touch", [](std::mt19937& engine, const Geometry::Polygon&) {
+			// Sharing an end, as neighbouring edges of a path or polygon do
+			const float angle = RandomAngle(engine);
+			const Geometry::Vector2<float> shared = AtAngle(angle, 1.0f);
+			return Query{ 0, AtAngle(angle, -1.0f), shared, shared, shared + AtAngle(angle + Uniform(engine, 0.5f, 2.5f), 1.0f) };
+		} },
+		{ "collinear", [](std::mt19937& engine, const Geometry::Polygon&) {
+			const float angle = RandomAngle(engine);
+			return Query{ 0, AtAngle(angle, -1.0f), AtAngle(angle, 1.0f), AtAngle(angle, Uniform(engine, -0.5f, 0.5f)), AtAngle(angle, 2.0f) };
+		} }
+	};
+
+	// Angles from a over b to c
+	const std::vector<Case> ANGLE_CASES = {
+		{ "clockwise", [](std::mt19937& engine, const Geometry::Polygon&) {
+			const float angle = RandomAngle(engine);
+			return Query{ 0, AtAngle(angle, -1.0f), {}, AtAngle(angle + Uniform(engine, 0.1f, 3.0f), 1.0f) };
+		} },
+		{ "counterclockwise", [](std::mt19937& engine, const Geometry::Polygon&) {
+			const float angle = RandomAngle(engine);
+			return Query{ 0, AtAngle(angle, -1.0f), {}, AtAngle(angle - Uniform(engine, 0.1f, 3.0f), 1.0f) };
+		} },
+		{ "collinear", [](std::mt19937& engine, const Geometry::Polygon&) {
+			// As straight as floats allow, which rounds either way
+			const float angle = RandomAngle(engine);
+			return Query{ 0, AtAngle(angle, -1.0f), {}, AtAngle(angle, Uniform(engine, 0.5f, 2.0f)) };
+		} }
+	};
+}
+
+int RunKernels(int argc, char* argv[]) {
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::fprintf(stderr, "Usage: Benchmark --kernels [--sizes 3,4,5,6,8,12,16,32,64,128,256] [--queries 4096] [--time-ms 100] [--seed 1]\n");
+		return 1;
+	}
+
+	std::printf("kernel,case,vertices,queries,ns_per_op,mops_per_s,mvertices_per_s,hit_rate\n");
+
+	// The kernels that take no polygon. Intersecting two lines is as much work as projecting four vertices, and an angle three.
+	MeasureCases("Intersect lines", LINE_PAIR_CASES, 4, {}, [](const Query& query) {
+		return Geometry::Intersect(Geometry::Line{ query.a, query.b }, Geometry::Line{ query.c, query.d });
+	}, options);
+	MeasureCases("DirectionOfAngle", ANGLE_CASES, 3, {}, [](const Query& query) {
+		return Geometry::DirectionOfAngle(query.a, query.b, query.c) == Geometry::RotationalDirection::CLOCKWISE;
+	}, options);
+
+	for (size_t size : options.sizes) {
+		std::mt19937 engine(options.seed);
+		std::vector<Geometry::Polygon> polygons;
+		std::vector<Geometry::PolygonFeatures> features;
+		for (size_t variant = 0; variant < POLYGON_VARIANTS; ++variant) {
+			polygons.push_back(RegularPolygon(size, RandomAngle(engine)));
+			features.push_back(Geometry::ComputeFeatures(polygons.back()));
+		}
+
+		MeasureCases("Intersect polygon", LINE_CASES, size, polygons, [&polygons](const Query& query) {
+			return Geometry::Intersect(polygons[query.polygon], Geometry::Line{ query.a, query.b });
+		}, options);
+		MeasureCases("Intersect features", LINE_CASES, size, polygons, [&polygons, &features](const Query& query) {
+			return Geometry::Intersect(polygons[query.polygon], features[query.polygon], Geometry::Line{ query.a, query.b });
+		}, options);
+		MeasureCases("InPolygon", POINT_CASES, size, polygons, [&polygons](const Query& query) {
+			return Geometry::InPolygon(polygons[query.polygon], query.a);
+		}, options);
+
+		// Hits when the extrema are two different vertices, as they always should be from outside
+		MeasureCases("GetAnglularExtrema", VIEW_CASES, size, polygons, [&polygons](const Query& query) {
+			const auto [leftMost, rightMost] = Geometry::GetAnglularExtrema(polygons[query.polygon], query.a);
+			return leftMost != rightMost;
+		}, options);
+	}
+	return 0;
+}
\ No newline at end of file
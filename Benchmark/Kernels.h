@@ -0,0 +1,12 @@
+#pragma once
+
+// Measures the geometry kernels everything else is built on, Geometry::Intersect, InPolygon, GetAnglularExtrema and
+// DirectionOfAngle, each on its own. Every kernel that takes a polygon is measured on regular polygons from triangles up
+// to 256-gons, with queries that hit it, that miss it, and that are nearly degenerate, like lines along an edge or
+// through a vertex, which is what path finding asks about most. Prints one line of comma separated values per kernel,
+// case and polygon size, with the nanoseconds per call, the calls and polygon vertices per second in millions, and the
+// fraction of calls that hit, which tells whether a case is what it says.
+//
+// Run as "Benchmark --kernels", optionally followed by [--sizes 3,4,...,256] [--queries 4096] [--time-ms 100] [--seed 1].
+// argv[0] is "--kernels".
+int RunKernels(int argc, char* argv[]);
\ No newline at end of file
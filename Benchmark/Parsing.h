@@ -0,0 +1,27 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <vector>
+
+// Command line parsing shared by the benchmarks
+
+template <typename Number>
+bool ParseNumber(std::string_view text, Number& number) {
+	const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), number);
+	return error == std::errc{} && end == text.data() + text.size();
+}
+
+// Parses a comma separated list of numbers
+inline bool ParseList(std::string_view text, std::vector<size_t>& numbers) {
+	numbers.clear();
+	while (!text.empty()) {
+		const size_t comma = std::min(text.find(','), text.size());
+		if (!ParseNumber(text.substr(0, comma), numbers.emplace_back())) {
+			return false;
+		}
+		text.remove_prefix(std::min(comma + 1, text.size()));
+	}
+	return !numbers.empty();
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+// C++20 or newer
+
+#include "AStar.h"
+#include "ShortestPathMap.h"
+#include "HierarchicalPlanner.h"
+#include "WorldGenerator.h"
+#include "Parsing.h"
+#include "Kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <vector>
+
+// Measures AStar::FindPath over generated worlds of every size and layout asked for, at every thread count from 1 up,
+// in each of the ways the solver can use its threads. Prints one line of comma separated values per world, way and
+// thread count, with latency percentiles over a fixed set of queries, the nodes expanded per query, the speedup
+// over one thread, and how much longer than the shortest the paths found were. A line for a shortest path map follows
+// for each world, answering the same queries towards the goal of the first, with the time it took to build, and one for
+// hierarchical pathfinding, answering the very same queries.
+// Run with --help for the options, or see Kernels.h for measuring the geometry kernels on their own.
+
+namespace {
+
+	struct Options {
+		std::vector<size_t> polygonCounts{ 16, 64, 256 };
+		std::vector<Geometry::WorldParameters::Layout> layouts{ Geometry::WorldParameters::Layout::SCATTER, Geometry::WorldParameters::Layout::MAZE };
+		size_t vertexCount = 6;
+		float density = 0.3f;
+		size_t queryCount = 32;
+		size_t maxThreads = Threading::SharedPool().WorkerCount() + 1;
+		uint32_t seed = 1;
+	};
+
+	// The ways the solver can use its threads
+	struct Mode {
+		const char* name;
+		bool relaxedFringe;
+		bool parallelExpansion;
+	};
+	constexpr Mode MODES[] = {
+		{ "shared fringe", false, false },
+		{ "relaxed fringe", true, false },
+		{ "parallel expansion", false, true }
+	};
+
+	bool ParseOptions(int argc, char* argv[], Options& options) {
+		for (int argument = 1; argument + 1 < argc; argument += 2) {
+			const std::string_view option = argv[argument], value = argv[argument + 1];
+			bool valid = false;
+			if (option == "--polygons") {
+				valid = ParseList(value, options.polygonCounts);
+			}
+			else if (option == "--layout") {
+				options.layouts.clear();
+				for (size_t layout = 0; layout < static_cast<size_t>(Geometry::WorldParameters::Layout::LAYOUT_COUNT); ++layout) {
+					if (value == "all" || value == Geometry::LayoutName(static_cast<Geometry::WorldParameters::Layout>(layout))) {
+						options.layouts.push_back(static_cast<Geometry::WorldParameters::Layout>(layout));
+					}
+				}
+				valid = !options.layouts.empty();
+			}
+			else if (option == "--vertices") {
+				valid = ParseNumber(value, options.vertexCount) && options.vertexCount >= 3;
+			}
+			else if (option == "--density") {
+				valid = ParseNumber(value, options.density) && options.density > 0.0f && options.density <= 1.0f;
+			}
+			else if (option == "--queries") {
+				valid = ParseNumber(value, options.queryCount) && options.queryCount > 0;
+			}
+			else if (option == "--threads") {
+				valid = ParseNumber(value, options.maxThreads) && options.maxThreads > 0;
+			}
+			else if (option == "--seed") {
+				valid = ParseNumber(value, options.seed);
+			}
+			if (!valid) {
+				return false;
+			}
+		}
+		return argc % 2 == 1;
+	}
+
+	void SetThreadCount(size_t count) {
+		while (AStar::ThreadCount() > count) {
+			AStar::RemoveThread();
+		}
+		for (size_t previous = 0; AStar::ThreadCount() < count && AStar::ThreadCount() != previous;) {
+			previous = AStar::ThreadCount();
+			AStar::AddThread();
+		}
+	}
+
+	float Length(const Geometry::LineSequence& path) {
+		float length = 0.0f;
+		for (size_t vertex = 1; vertex < path.vertices.size(); ++vertex) {
+			length += (path.vertices[vertex] - path.vertices[vertex - 1]).Magnitude();
+		}
+		return length;
+	}
+
+	// How much longer path is than the shortest, as a fraction of it. A missing path is infinitely longer, unless there is none.
+	double Excess(const Geometry::LineSequence& path, float shortest) {
+		if (path.vertices.empty()) {
+			return shortest > 0.0f ? std::numeric_limits<double>::infinity() : 0.0;
+		}
+		return shortest > 0.0f ? std::max(0.0, static_cast<double>(Length(path) / shortest) - 1.0) : 0.0;
+	}
+
+	// The latency below which the given fraction of the sorted latencies lie
+	double Percentile(const std::vector<double>& sorted, double fraction) {
+		const size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+}
+
+int main(int argc, char* argv[]) {
+	if (argc > 1 && std::string_view(argv[1]) == "--kernels") {
+		return RunKernels(argc - 1, argv + 1);
+	}
+
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::fprintf(stderr, "Usage: Benchmark [--polygons 16,64,256] [--layout scatter|maze|poisson|corridors|clusters|slivers|collinear|all]\n"
+			"                 [--vertices 6] [--density 0.3] [--queries 32] [--threads <most threads>] [--seed 1]\n"
+			"       Benchmark --kernels [--sizes 3,4,5,6,8,12,16,32,64,128,256] [--queries 4096] [--time-ms 100] [--seed 1]\n");
+		return 1;
+	}
+
+	// Every solve uses exactly the threads it is given, rather than what the model picks
+	AStar::AdaptThreadCount(false);
+	std::printf("layout,polygons,vertices,mode,threads,queries,p50_ms,p90_ms,p99_ms,max_ms,mean_ms,nodes_expanded,speedup,max_excess,build_ms\n");
+
+	for (Geometry::WorldParameters::Layout layout : options.layouts) {
+		for (size_t polygonCount : options.polygonCounts) {
+			Geometry::WorldParameters parameters;
+			parameters.layout = layout;
+			parameters.polygonCount = polygonCount;
+			parameters.vertexCount = options.vertexCount;
+			parameters.density = options.density;
+			parameters.seed = options.seed;
+			std::vector<Geometry::Polygon> polygons = Geometry::GenerateWorld(parameters);
+			const size_t vertexCount = std::transform_reduce(polygons.begin(), polygons.end(), size_t{ 0 }, std::plus{},
+				[](const Geometry::Polygon& polygon) { return polygon.vertices.size(); });
+			const std::vector<Geometry::Vector2<float>> positions = Geometry::GenerateFreePositions(polygons, 2 * options.queryCount, options.seed);
+			const size_t actualPolygonCount = polygons.size();
+			const Geometry::World world = Geometry::Publish(std::move(polygons));
+
+			// The length of the path to each query, found by the first way with one thread, which every other way is held to
+			std::vector<float> shortest(options.queryCount, 0.0f);
+			for (const Mode& mode : MODES) {
+				AStar::UseRelaxedFringe(mode.relaxedFringe);
+				AStar::ExpandInParallel(mode.parallelExpansion);
+				double singleThreadTotal = 0.0;
+				for (size_t threads = 1; threads <= options.maxThreads; ++threads) {
+					SetThreadCount(threads);
+					if (AStar::ThreadCount() != threads) {
+						break;
+					}
+
+					// Warm up the arena, the pool and the caches before timing anything
+					AStar::FindPath(world, positions[0], positions[1]);
+
+					std::vector<double> latencies;
+					size_t nodesExpanded = 0;
+					double maxExcess = 0.0;
+					for (size_t query = 0; query < options.queryCount; ++query) {
+						const auto start = std::chrono::steady_clock::now();
+						const Geometry::LineSequence path = AStar::FindPath(world, positions[2 * query], positions[2 * query + 1]);
+						latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+						nodesExpanded += AStar::FringeStatistics().pops;
+						if (&mode == &MODES[0] && threads == 1) {
+							shortest[query] = Length(path);
+						}
+						maxExcess = std::max(maxExcess, Excess(path, shortest[query]));
+					}
+					const double total = std::accumulate(latencies.begin(), latencies.end(), 0.0);
+					if (threads == 1) {
+						singleThreadTotal = total;
+					}
+					std::ranges::sort(latencies);
+					std::printf("%s,%zu,%zu,%s,%zu,%zu,%.4f,%.4f,%.4f,%.4f,%.4f,%.1f,%.3f,%.4f,0\n",
+						Geometry::LayoutName(layout), actualPolygonCount, vertexCount, mode.name, threads, options.queryCount,
+						Percentile(latencies, 0.5), Percentile(latencies, 0.9), Percentile(latencies, 0.99), latencies.back(),
+						total / static_cast<double>(options.queryCount),
+						static_cast<double>(nodesExpanded) / static_cast<double>(options.queryCount),
+						total > 0.0 ? singleThreadTotal / total : 1.0, maxExcess);
+					std::fflush(stdout);
+				}
+			}
+
+			// A shortest path map only serves one goal, so its queries all head for that of the first, and are held to
+			// the paths the solver finds there. It expands no nodes, and a query only looks up the region it starts in.
+			SetThreadCount(1);
+			const Geometry::Vector2<float>& goal = positions[1];
+			const auto buildStart = std::chrono::steady_clock::now();
+			const AStar::ShortestPathMap map(Geometry::Prepare(world), goal);
+			const double buildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+			std::vector<double> latencies;
+			double maxExcess = 0.0;
+			for (size_t query = 0; query < options.queryCount; ++query) {
+				const auto start = std::chrono::steady_clock::now();
+				const Geometry::LineSequence path = map.FindPath(positions[2 * query]);
+				latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+				maxExcess = std::max(maxExcess, Excess(path, Length(AStar::FindPath(world, positions[2 * query], goal))));
+			}
+			const double total = std::accumulate(latencies.begin(), latencies.end(), 0.0);
+			std::ranges::sort(latencies);
+			std::printf("%s,%zu,%zu,shortest path map,1,%zu,%.4f,%.4f,%.4f,%.4f,%.4f,0,1.000,%.4f,%.4f\n",
+				Geometry::LayoutName(layout), actualPolygonCount, vertexCount, options.queryCount,
+				Percentile(latencies, 0.5), Percentile(latencies, 0.9), Percentile(latencies, 0.99), latencies.back(),
+				total / static_cast<double>(options.queryCount), maxExcess, buildTime);
+			std::fflush(stdout);
+
+			// Hierarchical pathfinding builds each cluster when a query first reaches it, so the first pass over the queries
+			// is timed as building, and the second as querying. Only the time of the first pass is kept, as the second finds
+			// the same paths.
+			AStar::HierarchicalPlanner hierarchical(world);
+			const auto hierarchicalStart = std::chrono::steady_clock::now();
+			for (size_t query = 0; query < options.queryCount; ++query) {
+				(void)hierarchical.FindPath(positions[2 * query], positions[2 * query + 1]);
+			}
+			const double hierarchicalBuildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - hierarchicalStart).count();
+			latencies.clear();
+			maxExcess = 0.0;
+			for (size_t query = 0; query < options.queryCount; ++query) {
+				const auto start = std::chrono::steady_clock::now();
+				const Geometry::LineSequence path = hierarchical.FindPath(positions[2 * query], positions[2 * query + 1]);
+				latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+				maxExcess = std::max(maxExcess, Excess(path, shortest[query]));
+			}
+			const double hierarchicalTotal = std::accumulate(latencies.begin(), latencies.end(), 0.0);
+			std::ranges::sort(latencies);
+			std::printf("%s,%zu,%zu,hierarchical,1,%zu,%.4f,%.4f,%.4f,%.4f,%.4f,0,1.000,%.4f,%.4f\n",
+				Geometry::LayoutName(layout), actualPolygonCount, vertexCount, options.queryCount,
+				Percentile(latencies, 0.5), Percentile(latencies, 0.9), Percentile(latencies, 0.99), latencies.back(),
+				hierarchicalTotal / static_cast<double>(options.queryCount), maxExcess, hierarchicalBuildTime);
+			std::fflush(stdout);
+		}
+	}
+	return 0;
+}
\ No newline at end of file
@@ -2,189 +2,467 @@
 
 namespace AStar {
 
-	WorkerThread::WorkerThread(Solver& solver) {
+	void Solver::Solve(Geometry::World world, const Geometry::Vector2<float> startingPosition, const Geometry::Vector2<float> goal, SolveStatistics* statistics) {
+		const bool worldChanged = !this->world || this->world->version != world->version;
+		this->world = std::move(world);
+		this->goal = goal;
+		completePath.reset();
+		bestLength = std::numeric_limits<float>::infinity();
 
-		thread = std::thread([&]() {
-			
-			// Might as well be while(true), but it does not look the nicest
-			while (alive) {
+		// Landmark distances only depend on the world, so they are kept for as long as it stays the same
+		if (landmarkCount == 0) {
+			graph.reset();
+			landmarks.reset();
+		}
+		else {
+			if (worldChanged || !graph) {
+				graph.emplace(this->world->polygons, Geometry::VisibilityGraph::Lines::EXTREMUM);
+				landmarks.reset();
+			}
+			if (!landmarks || landmarks->Count() != std::min(landmarkCount, graph->vertices.size())) {
+				landmarks.emplace(*graph, landmarkCount);
+			}
+			landmarks->SetGoal(this->world->polygons, *graph, goal);
+		}
 
-				// Block until main thread gives the signal to begin
-				beginSignal.acquire();
+		// Pick how many threads to use. Measurements only compare within one way of using threads, so start over when that changes.
+		if (modelledMode != std::make_pair(parallelExpansion, relaxedFringe)) {
+			modelledMode = { parallelExpansion, relaxedFringe };
+			threadCountModel.Reset();
+		}
+		const size_t vertexCount = std::transform_reduce(this->world->polygons.begin(), this->world->polygons.end(), size_t{ 0 }, std::plus{},
+			[](const Geometry::Polygon& polygon) { return polygon.vertices.size(); });
+		const size_t work = ThreadCountModel::Work(vertexCount, this->world->polygons.size());
+		activeThreadCount = adaptiveThreadCount ? threadCountModel.Choose(work, threadCount) : threadCount;
+		const auto searchStart = std::chrono::steady_clock::now();
+
+		discoveredLengths.Reset(arena.Resource());
+		if (statistics) {
+			expandedLengths.Reset(arena.Resource());
+			// Reuse the memory the caller's statistics kept from the last solve, so that it is only allocated once
+			std::vector<SolveStatistics::Thread> threads = std::move(statistics->threads);
+			threads.assign(parallelExpansion ? 1 : activeThreadCount, {});
+			collected = {};
+			collected.nodesDiscovered = 1; // The start
+			collected.threads = std::move(threads);
+		}
+		fringeWaited = 0;
+		fringe.emplace([](const Node& lhs, const Node& rhs) {
+			// We want to prioritize a node n the lower its f(n) = g(n) + h(n), where
+			// g(n) is the cost of the node n, i.e. the length of the path to it, and
+			// h(n) is the heuristic, a lower bound on the distance to the goal
+
+			return lhs.pathLength() + lhs.heuristic > rhs.pathLength() + rhs.heuristic;
+		}, std::pmr::vector<Node>(arena.Resource()));
+		fringeStatistics = {};
+		if (relaxedFringe) {
+			if (!relaxedNodes) {
+				relaxedNodes = std::make_unique<Threading::MultiQueue<Node>>(Constants::HEAPS_PER_THREAD * (Threading::SharedPool().WorkerCount() + 1));
+			}
+			relaxedNodes->Reset(Constants::HEAPS_PER_THREAD * activeThreadCount, arena.Resource());
+		}
+		Node start(startingPosition, arena.Resource());
+		start.heuristic = Heuristic(startingPosition);
+		PushToFringe<false>(start);
+
+		// Run the search on pool workers, unless they are to help with the expansions instead
+		Threading::ThreadPool& pool = Threading::SharedPool();
+		Threading::TaskGroup searchers;
+		for (size_t thread = 1; thread < activeThreadCount && !parallelExpansion; ++thread) {
+			pool.Submit(searchers, [this, thread, statistics]() { statistics ? Run<true>(thread) : Run<false>(thread); });
+		}
 
-				// Check if main thread called destructor
-				if (!alive) 
-					break;
+		// And main thread, which then helps with whatever is left until every searcher is done
+		statistics ? Run<true>(0) : Run<false>(0);
+		pool.Wait(searchers);
+		threadCountModel.Record(activeThreadCount, work, std::chrono::steady_clock::now() - searchStart);
+		
+		// Clean up solver, giving back everything allocated from the arena before resetting it
+		if (relaxedFringe) {
+			fringeStatistics = relaxedNodes->GetStatistics();
+		}
+		if (statistics) {
+			collected.fringePeak = fringeStatistics.peakSize;
+			collected.fringeWait = std::chrono::nanoseconds(fringeWaited.load());
+			collected.discoveredWait = discoveredLengths.Waited();
+			*statistics = std::move(collected);
+			expandedLengths.Release();
+		}
+		if (completePath) {
+			CheckHeuristic(*completePath);
+		}
+		foundPath = completePath ? Geometry::LineSequence{ { completePath->path.begin(), completePath->path.end() } } : Geometry::LineSequence{};
+		completePath.reset();
+		discoveredLengths.Release();
+		fringe.reset();
+		if (relaxedNodes) {
+			relaxedNodes->Release();
+		}
+		arena.Reset();
+	}
 
-				// Run solver algorithm
-				solver.Run();
 
-				// Signal main thread that work is complete and allow it to unblock
-				completeSignal.release();
+	// The distance to the goal, or the landmark bound if that is greater. The landmark distances are measured over every line
+	// the search follows, so that neither bound exceeds the length of any path it can find, and neither does their maximum.
+	float Solver::Heuristic(const Geometry::Vector2<float>& position) const noexcept {
+		const float distance = (goal - position).Magnitude();
+		if (!landmarks || position == goal) {
+			return distance;
+		}
+		if (auto id = graph->IdOf(position)) {
+			return std::max(distance, landmarks->Heuristic(*id));
+		}
+		return distance;
+	}
 
+	void Solver::CheckHeuristic(const Node& found) const NOEXCEPT_IF_NOT_DEBUG {
+		float remaining = found.pathLength();
+		for (size_t step = 0; step + 1 < found.path.size(); ++step) {
+			if (Heuristic(found.path[step]) > remaining * (1.0f + Constants::EPSILON) + Constants::EPSILON) {
+				THROW_IF_DEBUG("AStar::Solver::Heuristic overestimated the distance to the goal along the path found");
 			}
-		});
+			remaining -= (found.path[step + 1] - found.path[step]).Magnitude();
+		}
 	}
 
-	WorkerThread::~WorkerThread() {
-		// Signal worker to begin with !alive and wait for thread to join
-		alive = false;
-		beginSignal.release();
-		if (thread.joinable())
-			thread.join();
+	// Handles the discovery of a node. If it is already discovered by a shorter path, do nothing. Else, record its length and push it to the fringe
+	template <bool Collect>
+	void Solver::Discover(Node node, Counters& counters) {
+		using Lowering = decltype(discoveredLengths)::Lowering;
+		const Lowering lowering = discoveredLengths.Lower<Collect>(node.position(), node.pathLength());
+		if (lowering == Lowering::KEPT) {
+			return;
+		}
+		if constexpr (Collect) {
+			++(lowering == Lowering::INSERTED ? counters.discovered : counters.duplicatePushes);
+		}
+
+		// Nothing is found by expanding the goal, so a path reaching it is kept rather than pushed
+		if (node.position() == goal) {
+			Complete(node);
+			return;
+		}
+		node.heuristic = Heuristic(node.position());
+		PushToFringe<Collect>(std::move(node));
 	}
 
-	void Solver::Solve(const std::vector<Geometry::Polygon>& world, const Geometry::Vector2<float> startingPosition, const Geometry::Vector2<float> goal) {
-		this->world = world;
-		this->goal = goal;
-		completePath.reset();
-		fringe = std::priority_queue<Node, std::vector<Node>, std::function<bool(const Node&, const Node&)>>([&goal](const Node& lhs, const Node& rhs) {
-			// We want to prioritize a node n the lower its f(n) = g(n) + h(n), where
-			// g(n) is the cost of the node n, i.e. the length of the path to it, and
-			// h(n) is the heuristic, in this case the distance to the goal
-
-			return lhs.pathLength() + (goal - lhs.position()).Magnitude() > rhs.pathLength() + (goal - rhs.position()).Magnitude();
-		});
-		fringe.push(Node(startingPosition, {}));
-
-		// Run threadpool
-		std::for_each(std::execution::unseq, threadPool.begin(), threadPool.end(), [](auto& thread) {
-			// Signal the worker to begin
-			thread->beginSignal.release();
-		});
-
-		// And main thread
-		Run();
-
-		// Allow all threads to complete
-		std::for_each(std::execution::unseq, threadPool.begin(), threadPool.end(), [](auto& thread) {
-			// Block until that thread signals completion
-			thread->completeSignal.acquire();
-		});
-		
-		// Clean up solver
-		discoveredNodes.clear();
-		fringe = {};
+	void Solver::Complete(const Node& node) {
+		std::lock_guard lock(pathMutex);
+		if (!completePath || node.pathLength() < completePath->pathLength()) {
+			completePath = node;
+			bestLength.store(node.pathLength(), std::memory_order_relaxed);
+		}
 	}
 
+	template <bool Collect>
+	void Solver::PushToFringe(Node node) {
+		// f(n) never overestimates the length of a path through n, so n cannot lead to one shorter than the best found
+		if (node.pathLength() + node.heuristic >= bestLength.load(std::memory_order_relaxed)) {
+			return;
+		}
+		if (relaxedFringe) {
+			const float priority = node.pathLength() + node.heuristic;
+			relaxedNodes->Push(std::move(node), priority);
+			return;
+		}
+		auto lock = LockFringe<Collect>();
+		fringe->push(std::move(node));
+		++fringeStatistics.pushes;
+		fringeStatistics.peakSize = std::max(fringeStatistics.peakSize, fringe->size());
+	}
 
-	// Handles the discovery of a node. If it is already discovered, do nothing. Else, insert into discovered set and fringe
-	void Solver::Discover(const Node& node) {
-		// Scope for discovered set lock guard (probably quite insignificant)
-		{
-			std::lock_guard lock(discoveredMutex);
-			if (discoveredNodes.contains(node)) {
-				if (discoveredNodes.find(node)->pathLength() < node.pathLength()) {
-					return;
-				}
-				else {
-					discoveredNodes.erase(node);
-				}
+	// Only a lock that is taken has to be waited for, and timed, which keeps the clock out of uncontended locking
+	template <bool Collect>
+	std::unique_lock<std::mutex> Solver::LockFringe() {
+		if constexpr (Collect) {
+			std::unique_lock lock(fringeMutex, std::try_to_lock);
+			if (!lock) {
+				const auto start = std::chrono::steady_clock::now();
+				lock.lock();
+				fringeWaited.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
 			}
-			discoveredNodes.insert(node);
+			return lock;
+		}
+		else {
+			return std::unique_lock(fringeMutex);
 		}
-		std::lock_guard lock(fringeMutex);
-		fringe.push(node);
 	}
 
 	// Locks the fringe and takes the top node
+	template <bool Collect>
 	std::optional<Solver::Node> Solver::AqcuireNextNodeInFringe() {
-		std::lock_guard lock(fringeMutex);
-		if (fringe.empty()) {
+		if (relaxedFringe) {
+			return AqcuireNextNodeInRelaxedFringe();
+		}
+		auto lock = LockFringe<Collect>();
+		if (fringe->empty()) {
 			return {};
 		}
-		Node top = fringe.top();
-		fringe.pop();
+		Node top = fringe->top();
+		fringe->pop();
+		++fringeStatistics.pops;
 		return std::make_optional(top);
 	}
 
+	// Takes a node from the relaxed fringe, which the caller must be counted busy for. If the fringe is empty, the caller
+	// waits while other searchers are busy, as they may push more, and gives up once none are, or once the fringe only
+	// holds nodes that cannot lead to a shorter path. It is no longer counted busy when nothing is returned.
+	std::optional<Solver::Node> Solver::AqcuireNextNodeInRelaxedFringe() {
+		if (std::optional<Node> node = relaxedNodes->Pop()) {
+			return node;
+		}
+		busySearchers.fetch_sub(1);
+		for (;;) {
+			if (relaxedNodes->Empty()) {
+				if (busySearchers.load() == 0) {
+					return {};
+				}
+				std::this_thread::yield();
+				continue;
+			}
+			if (relaxedNodes->LowestPriority() >= bestLength.load(std::memory_order_relaxed)) {
+				return {};
+			}
+			busySearchers.fetch_add(1);
+			if (std::optional<Node> node = relaxedNodes->Pop()) {
+				return node;
+			}
+			busySearchers.fetch_sub(1);
+		}
+	}
+
 	// Threaded function
-	void Solver::Run() {
-		while (std::optional<Node> node = AqcuireNextNodeInFringe()) {
+	template <bool Collect>
+	void Solver::Run(size_t searcher) {
+
+		const std::vector<Geometry::Polygon>& polygons = world->polygons;
+		[[maybe_unused]] std::chrono::steady_clock::time_point runStart;
+		if constexpr (Collect) {
+			runStart = std::chrono::steady_clock::now();
+		}
+		std::chrono::nanoseconds busy{};
+		Counters counters;
+
+		// Kept across expansions so that their capacity is reused
+		std::pmr::vector<std::pmr::vector<Geometry::Vector2<float>>> neighbours(arena.Resource());
+		std::pmr::vector<Counters> chunkCounters(arena.Resource());
+		if (relaxedFringe) {
+			busySearchers.fetch_add(1);
+		}
+		while (std::optional<Node> node = AqcuireNextNodeInFringe<Collect>()) {
+			if constexpr (Collect) {
+				++counters.popped;
+			}
 
-			// Done?
-			if (completePath) {
-				std::lock_guard lock(pathMutex);
-				if (node->pathLength() >= completePath->pathLength()) {
+			// Done? Not if some node may still lead to a shorter path than the one found. The shared fringe pops the node
+			// with the lowest f(n), so then none can. A relaxed fringe only pops one nearly the lowest, so there this node
+			// is dropped, and the search only ends once no node left in any heap is better.
+			const float best = bestLength.load(std::memory_order_relaxed);
+			if (node->pathLength() + node->heuristic >= best) {
+				if (!relaxedFringe) {
 					break;
 				}
+				if (relaxedNodes->LowestPriority() >= best) {
+					busySearchers.fetch_sub(1);
+					break;
+				}
+				continue;
+			}
+
+			[[maybe_unused]] std::chrono::steady_clock::time_point expansionStart;
+			if constexpr (Collect) {
+				expansionStart = std::chrono::steady_clock::now();
+				if (expandedLengths.Lower(node->position(), node->pathLength()) != decltype(expandedLengths)::Lowering::INSERTED) {
+					++counters.reopenings;
+				}
 			}
 
-			// Is this the goal?
+			// Only the start can be the goal, as the goal is never pushed once discovered
 			if (node->position() == goal) {
-				std::lock_guard lock(pathMutex);
-				completePath = node;
+				Complete(*node);
+				continue;
 			}
 
 			// Is the goal visible?
-			if (!Geometry::Intersect(world, { node->position(), goal })) {
-				Discover(Node(goal, node->path));
+			if (!Blocked<Collect>({ node->position(), goal }, counters)) {
+				Discover<Collect>(Node(goal, *node), counters);
 			}
 
-			// Discover neighbours
-			std::for_each(std::execution::unseq, world.begin(), world.end(), [&](const Geometry::Polygon& polygon) {
-				auto found = std::find_if(std::execution::unseq, polygon.vertices.begin(), polygon.vertices.end(), 
-					[&node](const Geometry::Vector2<float>& vertex) { return node->position() == vertex; }); // unseq, at most one vertex could be the node
-				if (found != polygon.vertices.end()) {
-					// node belongs to polygon
-
-					// Discover node -1
-					if (found == polygon.vertices.begin()) {
-						Discover(Node(polygon.vertices.back(), node->path));
-					}
-					else {
-						Discover(Node(*(found - 1), node->path));
-					}
-
-					// Discover node +1
-					if (found == polygon.vertices.end() - 1) {
-						Discover(Node(polygon.vertices.front(), node->path));
-					}
-					else {
-						Discover(Node(*(found + 1), node->path));
+			// Find the neighbours, splitting the polygons into a chunk per thread when expanding in parallel.
+			// Every chunk fills a buffer of its own, so nothing is shared until the buffers are discovered below.
+			const size_t chunkCount = parallelExpansion ? std::clamp<size_t>(polygons.size(), 1, activeThreadCount) : 1;
+			neighbours.resize(chunkCount);
+			for (auto& chunk : neighbours) {
+				chunk.clear();
+			}
+			if (chunkCount > 1) {
+				// Without collecting, nothing is counted, so the chunks need no counters of their own
+				if constexpr (Collect) {
+					chunkCounters.assign(chunkCount, Counters{});
+				}
+				const size_t chunkSize = (polygons.size() + chunkCount - 1) / chunkCount;
+				Threading::SharedPool().ParallelFor(polygons.size(), chunkSize, [&](size_t first, size_t last) {
+					Expand<Collect>(*node, first, last, neighbours[first / chunkSize], Collect ? chunkCounters[first / chunkSize] : counters);
+				});
+				if constexpr (Collect) {
+					for (const Counters& chunk : chunkCounters) {
+						counters += chunk;
 					}
+				}
+			}
+			else {
+				Expand<Collect>(*node, 0, polygons.size(), neighbours.front(), counters);
+			}
 
+			for (const auto& chunk : neighbours) {
+				for (const auto& neighbour : chunk) {
+					Discover<Collect>(Node(neighbour, *node), counters);
 				}
-				else {
+			}
+			if constexpr (Collect) {
+				busy += std::chrono::steady_clock::now() - expansionStart;
+			}
+		}
 
-					// Discover all "visible" polygon angular extrema
-					const auto& [leftMost, rightMost] = Geometry::GetAnglularExtrema(polygon, node->position());
-					if (!Geometry::Intersect(world, { node->position(), leftMost })) {
-						Discover(Node(leftMost, node->path));
-					}
-					if (!Geometry::Intersect(world, { node->position(), rightMost })) {
-						Discover(Node(rightMost, node->path));
-					}
+		if constexpr (Collect) {
+			const std::chrono::nanoseconds total = std::chrono::steady_clock::now() - runStart;
+			std::lock_guard lock(statisticsMutex);
+			collected.nodesPopped += counters.popped;
+			collected.nodesDiscovered += counters.discovered;
+			collected.duplicatePushes += counters.duplicatePushes;
+			collected.reopenings += counters.reopenings;
+			collected.intersectCalls += counters.intersectCalls;
+			collected.polygonTests += counters.polygonTests;
+			collected.earlyRejections += counters.earlyRejections;
+			collected.threads[searcher] = { busy, total - busy };
+		}
+	};
+
+	template <bool Collect>
+	void Solver::Expand(const Node& node, size_t firstPolygon, size_t lastPolygon,
+		std::pmr::vector<Geometry::Vector2<float>>& neighbours, Counters& counters) const NOEXCEPT_IF_NOT_DEBUG {
+
+		const std::vector<Geometry::Polygon>& polygons = world->polygons;
+		const auto position = node.position();
+		for (size_t index = firstPolygon; index < lastPolygon; ++index) {
+			const Geometry::Polygon& polygon = polygons[index];
+			auto found = std::find(polygon.vertices.begin(), polygon.vertices.end(), position);
+			if (found != polygon.vertices.end()) {
+				// node belongs to polygon
+
+				// Discover node -1
+				neighbours.push_back(found == polygon.vertices.begin() ? polygon.vertices.back() : *(found - 1));
+
+				// Discover node +1
+				neighbours.push_back(found == polygon.vertices.end() - 1 ? polygon.vertices.front() : *(found + 1));
+			}
+			else {
 
+				// Discover all "visible" polygon angular extrema
+				const auto& [leftMost, rightMost] = Geometry::GetAnglularExtrema(polygon, position);
+				if (!Blocked<Collect>({ position, leftMost }, counters)) {
+					neighbours.push_back(leftMost);
+				}
+				if (!Blocked<Collect>({ position, rightMost }, counters)) {
+					neighbours.push_back(rightMost);
 				}
-			});
+			}
 		}
-	};
+	}
+
+	template <bool Collect>
+	bool Solver::Blocked(const Geometry::Line& line, Counters& counters) const NOEXCEPT_IF_NOT_DEBUG {
+		if constexpr (Collect) {
+			++counters.intersectCalls;
+		}
+		for (const Geometry::Polygon& polygon : world->polygons) {
+			if constexpr (Collect) {
+				++counters.polygonTests;
+			}
+			if (Geometry::SeparatedAlongLine(polygon, line)) {
+				if constexpr (Collect) {
+					++counters.earlyRejections;
+				}
+			}
+			else if (!Geometry::SeparatedAlongEdges(polygon, line)) {
+				return true;
+			}
+		}
+		return false;
+	}
 
-	Geometry::LineSequence FindPath(const std::vector<Geometry::Polygon>& world, const Geometry::Vector2<float>& startingPosition, const Geometry::Vector2<float>& goal) {
+	Geometry::LineSequence FindPath(const Geometry::World& world, const Geometry::Vector2<float>& startingPosition, const Geometry::Vector2<float>& goal,
+		SolveStatistics* statistics) {
 
 		// If you wish, uncomment and #include iostream to test the difference.
 
 		//auto start = std::chrono::steady_clock::now();
-		solver.Solve(world, startingPosition, goal);
+		solver.Solve(world, startingPosition, goal, statistics);
 		// auto duration = std::chrono::steady_clock::now() - start;
 
-		// std::cout << solver.threadPool.size() + 1 << " threads: " << duration << '\n';
+		// std::cout << solver.activeThreadCount << " threads: " << duration << '\n';
 
-		return solver.completePath ? solver.completePath->path : Geometry::LineSequence{};
+		return std::move(solver.foundPath);
 	}
 
 	void AddThread() {
-		solver.threadPool.push_back(std::make_unique<WorkerThread>(solver));
+		// More searchers than the pool has workers would only queue up behind each other
+		if (solver.threadCount < Threading::SharedPool().WorkerCount() + 1) {
+			++solver.threadCount;
+		}
 	}
 
 	void RemoveThread() {
-		if (!solver.threadPool.empty()) {
-			solver.threadPool.pop_back();
+		if (solver.threadCount > 1) {
+			--solver.threadCount;
 		}
 	}
 
 	size_t ThreadCount() {
-		return solver.threadPool.size() + 1;
+		return solver.threadCount;
+	}
+
+	void UseLandmarks(size_t count) {
+		solver.landmarkCount = count;
+	}
+
+	size_t LandmarkCount() {
+		return solver.landmarkCount;
+	}
+
+	void ExpandInParallel(bool parallel) {
+		solver.parallelExpansion = parallel;
+	}
+
+	bool ExpandsInParallel() {
+		return solver.parallelExpansion;
+	}
+
+	void UseRelaxedFringe(bool relaxed) {
+		solver.relaxedFringe = relaxed;
+	}
+
+	bool UsesRelaxedFringe() {
+		return solver.relaxedFringe;
+	}
+
+	Threading::QueueStatistics FringeStatistics() {
+		return solver.fringeStatistics;
+	}
+
+	void AdaptThreadCount(bool adapt) {
+		solver.adaptiveThreadCount = adapt;
+	}
+
+	bool AdaptsThreadCount() {
+		return solver.adaptiveThreadCount;
+	}
+
+	size_t LastThreadCount() {
+		return solver.activeThreadCount;
+	}
+
+	size_t ArenaPeak() {
+		return solver.arena.Peak();
 	}
-}
+}
\ No newline at end of file
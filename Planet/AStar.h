@@ -1,92 +1,269 @@
 #pragma once
 
 #include "Shapes.h"
-#include <thread>
+#include "Landmarks.h"
+#include "World.h"
+#include "ThreadPool.h"
+#include "MultiQueue.h"
+#include "StripedMap.h"
+#include "ThreadCountModel.h"
+#include "Arena.h"
+#include "Constants.h"
 #include <functional>
 #include <queue>
 #include <mutex>
-#include <unordered_set>
 #include <algorithm>
 #include <optional>
-#include <semaphore>
 #include <numeric>
-#include <execution>
+#include <memory_resource>
 #include <chrono>
+#include <atomic>
+#include <vector>
+#include <limits>
 
 namespace AStar {
 
-	class Solver;
+	// How hard a solve worked. Pass one to FindPath to have it filled in, which makes the solve a little slower.
+	struct SolveStatistics {
+		size_t nodesPopped = 0;     // Nodes taken off the fringe, the last few of which are only taken to see that the search is done
+		size_t nodesDiscovered = 0; // Positions reached for the first time
+		size_t duplicatePushes = 0; // Positions reached again by a shorter path, which pushes them to the fringe once more
+		size_t reopenings = 0;      // Nodes expanded at a position expanded before, as nodes that a shorter path superseded still are
 
-	// Thread wrapper which associates a std::thread with a state
-	struct WorkerThread {
+		// Lines tested against the world for visibility, the polygons they were tested against, and how many of those the
+		// cheapest test, along the line's own normal, ruled out
+		size_t intersectCalls = 0;
+		size_t polygonTests = 0;
+		size_t earlyRejections = 0;
 
-		// Signals allow the worker and main threads to when to begin execution and when it is complete
-		std::binary_semaphore beginSignal{0}, completeSignal{0};
-		std::atomic<bool> alive{true};
-		std::thread thread;
-		WorkerThread(Solver& solver);
-		~WorkerThread();
+		size_t fringePeak = 0; // The most nodes the fringe held at once
+
+		// Time spent waiting for other threads to let go of the fringe, or of the table of discovered lengths, over all
+		// threads. A relaxed fringe is never waited for, but tries other heaps instead, as counted by FringeStatistics.
+		std::chrono::nanoseconds fringeWait{};
+		std::chrono::nanoseconds discoveredWait{};
+
+		// For each thread that ran the search, the time it spent expanding nodes, and the rest of its time in the search.
+		// Expanding in parallel, only one thread runs the search, and the threads it splits expansions with are busy with it.
+		struct Thread {
+			std::chrono::nanoseconds busy{};
+			std::chrono::nanoseconds idle{};
+		};
+		std::vector<Thread> threads;
 	};
 
 	class Solver {
 
 		struct Node {
 
-			Node(Geometry::Vector2<float> position, Geometry::LineSequence parentPath) : path(parentPath) {
-				path.vertices.push_back(position);
+			// The start of a search, with its path allocated from resource
+			Node(Geometry::Vector2<float> position, std::pmr::memory_resource* resource) : path({ position }, resource) {}
+
+			// A step from parent to position, with its path allocated from wherever the parent's is
+			Node(Geometry::Vector2<float> position, const Node& parent) : path(parent.path.get_allocator()),
+				length(parent.length + (position - parent.position()).Magnitude()) {
+				path.reserve(parent.path.size() + 1);
+				path.assign(parent.path.begin(), parent.path.end());
+				path.push_back(position);
 			}
-			Geometry::LineSequence path;
+
+			// Copying a pmr vector allocates from the default resource, so copies are made to keep to the original's instead
+			Node(const Node& other) : path(other.path, other.path.get_allocator()), length(other.length), heuristic(other.heuristic) {}
+			Node(Node&&) = default;
+			Node& operator=(const Node&) = default;
+			Node& operator=(Node&&) = default;
+
+			std::pmr::vector<Geometry::Vector2<float>> path;
+
+			// g(n), summed up step by step as the path grows
+			float length = 0.0f;
+
+			// h(n), evaluated once when the node is discovered
+			float heuristic = 0.0f;
+
 			Geometry::Vector2<float> position() const {
-				return path.vertices.back();
+				return path.back();
 			}
 
-			float pathLength() const {
-				std::vector<Geometry::Vector2<float>> steps(path.vertices.size());
-				auto stepsEnd = std::adjacent_difference(std::execution::unseq, path.vertices.begin(), path.vertices.end(), steps.begin()); // unseq is always fastest
-				return std::transform_reduce(std::execution::unseq, steps.begin(), stepsEnd, 0.0f, std::plus{}, [](auto& vector) { return vector.Magnitude(); }); // here too
+			float pathLength() const noexcept {
+				return length;
 			}
 		};
 
-		friend Geometry::LineSequence FindPath(const std::vector<Geometry::Polygon>& world, const Geometry::Vector2<float>& startingPosition, const Geometry::Vector2<float>& goal);
+		// What a thread counts during a solve that collects statistics, without sharing anything with the other threads
+		// until it is done
+		struct Counters {
+			size_t popped = 0, discovered = 0, duplicatePushes = 0, reopenings = 0;
+			size_t intersectCalls = 0, polygonTests = 0, earlyRejections = 0;
+
+			Counters& operator+=(const Counters& other) noexcept {
+				popped += other.popped;
+				discovered += other.discovered;
+				duplicatePushes += other.duplicatePushes;
+				reopenings += other.reopenings;
+				intersectCalls += other.intersectCalls;
+				polygonTests += other.polygonTests;
+				earlyRejections += other.earlyRejections;
+				return *this;
+			}
+		};
+
+		friend Geometry::LineSequence FindPath(const Geometry::World& world, const Geometry::Vector2<float>& startingPosition,
+			const Geometry::Vector2<float>& goal, SolveStatistics* statistics);
 		friend void AddThread();
 		friend void RemoveThread();
 		friend size_t ThreadCount();
+		friend void UseLandmarks(size_t count);
+		friend size_t LandmarkCount();
+		friend void ExpandInParallel(bool parallel);
+		friend bool ExpandsInParallel();
+		friend void UseRelaxedFringe(bool relaxed);
+		friend bool UsesRelaxedFringe();
+		friend Threading::QueueStatistics FringeStatistics();
+		friend void AdaptThreadCount(bool adapt);
+		friend bool AdaptsThreadCount();
+		friend size_t LastThreadCount();
+		friend size_t ArenaPeak();
+
+		// How many threads may run the search, the calling thread included. The rest are borrowed from the shared pool for each solve.
+		size_t threadCount = 1;
+
+		// How many of those a solve actually uses, which the model picks per solve unless adapting is turned off
+		size_t activeThreadCount = 1;
+		bool adaptiveThreadCount = true;
+		ThreadCountModel threadCountModel;
+		std::pair<bool, bool> modelledMode{ false, false };
 
-		friend WorkerThread;
+		// Rather than searching the fringe from several threads, search it from one and split every expansion across the active threads
+		bool parallelExpansion = false;
 
-		std::vector<std::unique_ptr<WorkerThread>> threadPool;
+		// Everything a solve allocates comes from here, and is given back all at once when it is done.
+		// Declared before all that allocates from it, so that it outlives them.
+		Arena arena;
 
 		std::mutex pathMutex;
 		std::optional<Node> completePath;
 
-		std::vector<Geometry::Polygon> world;
+		// The length of completePath, readable without pathMutex, so that nodes which cannot lead to a shorter path are
+		// dropped without locking anything
+		std::atomic<float> bestLength{ std::numeric_limits<float>::infinity() };
+
+		// The path out of the solve, copied out of the arena before it is reset
+		Geometry::LineSequence foundPath;
+
+		// The snapshot being solved in, held rather than copied
+		Geometry::World world;
 		Geometry::Vector2<float> goal;
 
-		// Threadsafe discovered set
-		std::mutex discoveredMutex;
-		std::unordered_set<Node, decltype([](const Node& node) {
-			return std::hash<float>{}(node.position().x) ^ std::hash<float>{}(node.position().y);
-		}), decltype([](const Node& lhs, const Node& rhs) {
-			return lhs.position() == rhs.position();
-		})> discoveredNodes;
+		// ALT heuristic, which is only built if landmarks are requested, and rebuilt whenever the world changes
+		size_t landmarkCount = 0;
+		std::optional<Geometry::VisibilityGraph> graph;
+		std::optional<Landmarks> landmarks;
+
+		// Threadsafe table of the shortest path length found to each discovered position
+		Threading::StripedMap<Geometry::Vector2<float>, float, Geometry::Vector2Hash> discoveredLengths;
+
+		// The positions expanded so far, with the shortest path each was expanded by, which is only kept to count reopenings
+		Threading::StripedMap<Geometry::Vector2<float>, float, Geometry::Vector2Hash> expandedLengths;
+
+		// Statistics are only collected when asked for, by searching with Collect set. Each thread adds what it counted to
+		// collected when it is done.
+		std::mutex statisticsMutex;
+		SolveStatistics collected;
 
 		// Threadsafe fringe
 		std::mutex fringeMutex;
-		std::priority_queue<Node, std::vector<Node>, std::function<bool(const Node&, const Node&)>> fringe;
+		std::atomic<long long> fringeWaited{ 0 }; // Nanoseconds threads spent waiting for fringeMutex
+		// Made for every solve on the arena, and destroyed before the arena is reset, as assigning an empty queue keeps its buffer
+		std::optional<std::priority_queue<Node, std::pmr::vector<Node>, std::function<bool(const Node&, const Node&)>>> fringe;
+
+		// Alternatively, a relaxed fringe without a global lock, with HEAPS_PER_THREAD heaps for every searching thread. It is
+		// made once with heaps for every thread there may be, and its entries are allocated from the arena.
+		bool relaxedFringe = false;
+		std::unique_ptr<Threading::MultiQueue<Node>> relaxedNodes;
+
+		// The searchers holding a node of the relaxed fringe, or trying to take one. One that finds the fringe empty
+		// waits for these to push more, and the search is over once none are left.
+		std::atomic<size_t> busySearchers{ 0 };
+		Threading::QueueStatistics fringeStatistics; // Counted under fringeMutex, or taken from the relaxed fringe when done
+
+		void Solve(Geometry::World world, const Geometry::Vector2<float> startingPosition, const Geometry::Vector2<float> goal, SolveStatistics* statistics);
+		float Heuristic(const Geometry::Vector2<float>& position) const noexcept;
+
+		// Throws, if debugging, if the heuristic of any position along the path found is greater than what is left of it,
+		// which would let the search prune the shortest path
+		void CheckHeuristic(const Node& found) const NOEXCEPT_IF_NOT_DEBUG;
+		template <bool Collect>
+		void Discover(Node node, Counters& counters);
+
+		// Keeps node as the complete path, unless one at least as short is already kept
+		void Complete(const Node& node);
+
+		// Pushes node, unless it cannot lead to a shorter path than the one found
+		template <bool Collect>
+		void PushToFringe(Node node);
+
+		// Appends the positions of the neighbours of node found among the polygons in [firstPolygon, lastPolygon).
+		// Only reads the solver, so any number of threads may expand disjoint ranges at once.
+		template <bool Collect>
+		void Expand(const Node& node, size_t firstPolygon, size_t lastPolygon,
+			std::pmr::vector<Geometry::Vector2<float>>& neighbours, Counters& counters) const NOEXCEPT_IF_NOT_DEBUG;
+
+		// Whether line intersects any polygon of the world, as Geometry::Intersect tells, though one test at a time so that
+		// they can be counted when collecting
+		template <bool Collect>
+		bool Blocked(const Geometry::Line& line, Counters& counters) const NOEXCEPT_IF_NOT_DEBUG;
 
-		void Solve(const std::vector<Geometry::Polygon>& world, const Geometry::Vector2<float> startingPosition, const Geometry::Vector2<float> goal);
-		void Discover(const Node& node);
+		// Locks fringeMutex, timing the wait for it only when collecting
+		template <bool Collect>
+		std::unique_lock<std::mutex> LockFringe();
+		template <bool Collect>
 		std::optional<Node> AqcuireNextNodeInFringe();
-		void Run();
+		std::optional<Node> AqcuireNextNodeInRelaxedFringe();
+
+		// Searches until the fringe runs dry or the path is found. searcher numbers the threads running the search from 0.
+		// Only searches that Collect count anything or read the clock, and the rest compile to no trace of it.
+		template <bool Collect>
+		void Run(size_t searcher);
 	};
 
 	
 
 	static Solver solver;
-	Geometry::LineSequence FindPath(const std::vector<Geometry::Polygon>& world,
-		const Geometry::Vector2<float>& startingPosition, const Geometry::Vector2<float>& goal);
+
+	// Fills in statistics, unless it is null, with how hard the solve worked
+	Geometry::LineSequence FindPath(const Geometry::World& world,
+		const Geometry::Vector2<float>& startingPosition, const Geometry::Vector2<float>& goal, SolveStatistics* statistics = nullptr);
 
 	void AddThread();
 	void RemoveThread();
 	size_t ThreadCount();
+
+	// Sets the number of landmarks used by the ALT heuristic. 0 uses the euclidean distance to the goal alone.
+	void UseLandmarks(size_t count);
+	size_t LandmarkCount();
+
+	// Sets whether the threads split the geometry of each expansion, instead of each expanding nodes of their own
+	void ExpandInParallel(bool parallel);
+	bool ExpandsInParallel();
+
+	// Sets whether the searching threads share a relaxed fringe, which pops nodes that are only nearly the best but never
+	// makes all threads wait on one lock
+	void UseRelaxedFringe(bool relaxed);
+	bool UsesRelaxedFringe();
+
+	// How the fringe was used during the last solve. Pops count the nodes expanded. Only a relaxed fringe fails locks.
+	// See SolveStatistics for more on how hard a solve worked.
+	Threading::QueueStatistics FringeStatistics();
+
+	// Sets whether each solve picks how many threads to use from its own measurements, with ThreadCount() as the most it may pick.
+	// Otherwise every solve uses ThreadCount() threads.
+	void AdaptThreadCount(bool adapt);
+	bool AdaptsThreadCount();
+
+	// How many threads the last solve used
+	size_t LastThreadCount();
+
+	// The most memory a single solve has needed so far, in bytes. Solves needing no more than this do not allocate from the global heap.
+	size_t ArenaPeak();
 }
\ No newline at end of file
@@ -1,8 +1,19 @@
 #include "Application.h"
 #include <algorithm>
+#include <utility>
+#include <cmath>
+#include <array>
 
+namespace {
 
-Application::Application(SDLWrapper::Screen& screen, SDLWrapper::Keyboard& keyboard, SDLWrapper::Mouse& mouse) :
+	// The keys that do something for as long as they are held, rather than once per press
+	constexpr std::array HELD_KEYS = {
+		SDLWrapper::Keyboard::KeyCode::W, SDLWrapper::Keyboard::KeyCode::A, SDLWrapper::Keyboard::KeyCode::S,
+		SDLWrapper::Keyboard::KeyCode::D, SDLWrapper::Keyboard::KeyCode::Q, SDLWrapper::Keyboard::KeyCode::E
+	};
+}
+
+Application::Application(SDLWrapper::Screen& screen, SDLWrapper::Keyboard& keyboard, SDLWrapper::Mouse& mouse, Stepping stepping) :
 	screen(&screen),
 	keyboard(&keyboard),
 	mouse(&mouse)
@@ -10,18 +21,185 @@ Application::Application(SDLWrapper::Screen& screen, SDLWrapper::Keyboard& keybo
 	screen.SubscribeToRenderEvent(this);
 	keyboard.SubscribeToPressEvent(this);
 	mouse.SubscribeToClickEvent(this);
+	SampleInput();
+	if (stepping == Stepping::REAL_TIME) {
+		simulation = std::jthread([this](std::stop_token stop) { Simulate(stop); });
+	}
 }
 
 Application::~Application() noexcept {
+	simulation.request_stop();
+	if (simulation.joinable()) simulation.join();
 	if (screen)     screen->DetachFromRenderEvent(this);
 	if (keyboard) keyboard->DetachFromPressEvent(this);
 	if (mouse)       mouse->DetachFromClickEvent(this);
 }
 
-bool Application::Update(std::chrono::duration<float> deltaTime) noexcept {
+void Application::Simulate(std::stop_token stop) noexcept {
+	using Clock = std::chrono::steady_clock;
+	const auto step = std::chrono::duration_cast<Clock::duration>(Constants::SIMULATION_STEP);
+	const auto maxLag = std::chrono::duration_cast<Clock::duration>(Constants::MAX_SIMULATION_LAG);
+	try {
+		auto nextStep = Clock::now();
+		while (!stop.stop_requested()) {
+
+			// Take the steps that are due. After falling far behind, as during a long solve, the steps furthest back are skipped
+			// rather than all taken at once.
+			const auto now = Clock::now();
+			nextStep = std::max(nextStep, now - maxLag);
+			if (nextStep <= now) {
+				while (nextStep <= now) {
+					Advance();
+					nextStep += step;
+				}
+				Publish(nextStep - step);
+			}
+			std::this_thread::sleep_until(nextStep);
+		}
+	}
+	catch (...) {
+		// Only thrown in debug, where the render thread rethrows it
+		simulationFailure = std::current_exception();
+	}
+	simulating = false;
+}
+
+void Application::Advance() noexcept {
+	HeldInput held;
+	{
+		std::lock_guard lock(inputMutex);
+		std::swap(pendingInput, handledInput);
+		held = heldInput;
+		if (recording) {
+			Record(stepCount - recordingStart, held);
+		}
+		++stepCount;
+	}
+	for (const Input& input : handledInput) {
+		if (input.kind == Input::Kind::KEY) {
+			HandleKey(input.key);
+		}
+		else {
+			HandleClick(input.button, Geometry::ScreenToWorld(input.mousePosition, camera));
+		}
+	}
+	handledInput.clear();
+	Step(Constants::SIMULATION_STEP, held);
+}
+
+void Application::Publish(std::chrono::steady_clock::time_point time) {
+	if (!worldDrawing || worldDrawing->version != world->version) {
+		auto drawing = std::make_shared<WorldDrawing>(world->version, Geometry::SpatialGrid(world->polygons, Constants::CULLING_CELL_SIZE));
+		drawing->detail.resize(world->polygons.size());
+		Threading::SharedPool().ParallelFor(world->polygons.size(), [this, &drawing](size_t first, size_t last) {
+			for (size_t index = first; index < last; ++index) {
+				drawing->detail[index] = Geometry::BuildDetailLevels(world->polygons[index]);
+			}
+		});
+		worldDrawing = std::move(drawing);
+	}
+
+	backFrame.time = time;
+	backFrame.world = world;
+	backFrame.drawing = worldDrawing;
+	backFrame.selectedIndex = selectedIndex;
+	backFrame.currentShape = currentShape;
+	backFrame.lastKnownValidVertex = lastKnownValidVertex;
+	backFrame.planet = planet;
+	backFrame.path = path;
+	backFrame.camera = camera;
+	backFrame.title = title;
+
+	std::lock_guard lock(frameMutex);
+	std::swap(previousFrame, latestFrame);
+	std::swap(latestFrame, backFrame);
+}
+
+size_t Application::StepCount() noexcept {
+	std::lock_guard lock(inputMutex);
+	return stepCount;
+}
 
-	if (ValidNextVertex(Geometry::ScreenToWorld(SDLWrapper::Mouse::GetPosition()))) {
-		lastKnownValidVertex = Geometry::ScreenToWorld(SDLWrapper::Mouse::GetPosition());
+void Application::StartRecording() {
+	std::lock_guard lock(inputMutex);
+	recording.emplace();
+	recordingStart = stepCount;
+	recordedHeld = {};
+}
+
+SDLWrapper::InputScript Application::StopRecording() {
+	std::lock_guard lock(inputMutex);
+	std::vector<SDLWrapper::InputScript::Event> events = recording ? std::move(*recording) : std::vector<SDLWrapper::InputScript::Event>{};
+	if (recording && stepCount > recordingStart) {
+		// Lasts as long as the recording did, even if nothing happened in the last steps
+		events.push_back({ .kind = SDLWrapper::InputScript::Event::Kind::END, .step = stepCount - recordingStart - 1 });
+	}
+	recording.reset();
+	return SDLWrapper::InputScript(std::move(events));
+}
+
+void Application::Record(size_t step, const HeldInput& held) {
+	using Event = SDLWrapper::InputScript::Event;
+	auto moveTo = [&](const Geometry::Vector2<int>& position) {
+		if (position != recordedHeld.mousePosition) {
+			recording->push_back({ .kind = Event::Kind::MOVE, .step = step, .position = position });
+			recordedHeld.mousePosition = position;
+		}
+	};
+
+	// Pressed keys are released right away, unless they are held, which leaves them free to be pressed again. Keys that
+	// do something when held are recorded as they are sampled instead, so that playing back samples them the same.
+	for (const Input& input : handledInput) {
+		moveTo(input.mousePosition);
+		if (input.kind == Input::Kind::CLICK) {
+			recording->push_back({ .kind = Event::Kind::CLICK, .step = step, .button = input.button });
+		}
+		else if (std::ranges::find(HELD_KEYS, input.key) == HELD_KEYS.end()) {
+			recording->push_back({ .kind = Event::Kind::PRESS, .step = step, .key = input.key });
+			recording->push_back({ .kind = Event::Kind::RELEASE, .step = step, .key = input.key });
+		}
+	}
+	moveTo(held.mousePosition);
+	for (SDLWrapper::Keyboard::KeyCode key : HELD_KEYS) {
+		if (held.IsPressed(key) != recordedHeld.IsPressed(key)) {
+			recording->push_back({ .kind = held.IsPressed(key) ? Event::Kind::PRESS : Event::Kind::RELEASE, .step = step, .key = key });
+		}
+	}
+	recordedHeld.keys = held.keys;
+}
+
+Geometry::Vector2<int> Application::MousePosition() const noexcept {
+	return mouse ? mouse->GetPosition() : Geometry::Vector2<int>{};
+}
+
+void Application::SampleInput() noexcept {
+	HeldInput held{ .mousePosition = MousePosition(), .keys = {} };
+	if (keyboard) {
+		for (SDLWrapper::Keyboard::KeyCode key : HELD_KEYS) {
+			held.keys.set(static_cast<size_t>(key), keyboard->IsPressed(key));
+		}
+	}
+	std::lock_guard lock(inputMutex);
+	heldInput = held;
+}
+
+void Application::Step(std::chrono::duration<float> deltaTime, const HeldInput& held) noexcept {
+
+	// Pan and zoom while the keys are held. Panning is scaled by the zoom, so that it crosses the screen equally fast at any zoom.
+	using enum SDLWrapper::Keyboard::KeyCode;
+	const Geometry::Vector2<float> pan{
+		static_cast<float>(held.IsPressed(D)) - static_cast<float>(held.IsPressed(A)),
+		static_cast<float>(held.IsPressed(S)) - static_cast<float>(held.IsPressed(W)) };
+	const float zoom = static_cast<float>(held.IsPressed(E)) - static_cast<float>(held.IsPressed(Q));
+	camera.center += pan * (deltaTime.count() * Constants::CAMERA_PAN_SPEED / camera.zoom);
+	if (zoom != 0.0f) {
+		camera.zoom = std::clamp(camera.zoom * std::pow(Constants::CAMERA_ZOOM_RATE, zoom * deltaTime.count()),
+			Constants::CAMERA_MIN_ZOOM, Constants::CAMERA_MAX_ZOOM);
+	}
+
+	const Geometry::Vector2<float> mouseInWorld = Geometry::ScreenToWorld(held.mousePosition, camera);
+	if (ValidNextVertex(mouseInWorld)) {
+		lastKnownValidVertex = mouseInWorld;
 	}
 
 	if (path.vertices.size() > 1) {
@@ -46,9 +224,6 @@ bool Application::Update(std::chrono::duration<float> deltaTime) noexcept {
 		}
 
 	}
-
-
-	return true;
 }
 
 bool Application::ValidNextVertex(const Geometry::Vector2<float> vertex) noexcept {
@@ -58,7 +233,7 @@ bool Application::ValidNextVertex(const Geometry::Vector2<float> vertex) noexcep
 
 	// Ensure there is no overlap
 	// case line:
-	if (Geometry::Intersect(world, { currentShape.back(), vertex })) {
+	if (Geometry::Intersect(world->polygons, { currentShape.back(), vertex })) {
 		return false;
 	}
 	
@@ -66,7 +241,7 @@ bool Application::ValidNextVertex(const Geometry::Vector2<float> vertex) noexcep
 	if (currentShape.size() > 1) {
 		Geometry::Polygon polygon{ currentShape };
 		polygon.vertices.push_back(vertex);
-		for (auto &worldPolygon : world) {
+		for (auto &worldPolygon : world->polygons) {
 			for (auto &worldVertex : worldPolygon.vertices) {
 				if (Geometry::InPolygon(polygon, worldVertex)) {
 					return false;
@@ -97,18 +272,90 @@ bool Application::ValidNextVertex(const Geometry::Vector2<float> vertex) noexcep
 };
 
 bool Application::OnRender(SDLWrapper::Screen::Renderer& renderer) NOEXCEPT_IF_NOT_DEBUG {
-	// World
-	for (auto it = world.begin(); it != world.end(); ++it) {
-		if (!renderer.RenderPolygon(*it, (selectedIndex.has_value() 
-			&& (it - world.begin() == selectedIndex) ? Color::PINK : Color::RED))) return false;
+	if (!simulating) {
+		if (simulationFailure) {
+			std::rethrow_exception(simulationFailure);
+		}
+		return false;
+	}
+
+	// Draw one step behind the simulation, between the two latest steps, so that motion is as smooth as the display allows
+	// however the steps line up with its refreshes
+	{
+		std::lock_guard lock(frameMutex);
+		renderedPrevious = previousFrame;
+		renderedLatest = latestFrame;
+	}
+	if (!renderedLatest.world) {
+		return true;
+	}
+	const auto renderTime = std::chrono::steady_clock::now() - std::chrono::duration_cast<std::chrono::steady_clock::duration>(Constants::SIMULATION_STEP);
+	const float alpha = renderedPrevious.world && renderedLatest.time > renderedPrevious.time
+		? std::clamp(std::chrono::duration<float>(renderTime - renderedPrevious.time) / std::chrono::duration<float>(renderedLatest.time - renderedPrevious.time), 0.0f, 1.0f)
+		: 1.0f;
+	Frame& frame = renderedLatest;
+	const Frame& previous = renderedPrevious.world ? renderedPrevious : renderedLatest;
+	const Geometry::Camera camera{ Geometry::NormalizedLerp(previous.camera.center, frame.camera.center, alpha),
+		std::lerp(previous.camera.zoom, frame.camera.zoom, alpha) };
+	const Geometry::Vector2<float> planet = Geometry::NormalizedLerp(previous.planet, frame.planet, alpha);
+	if (!frame.path.vertices.empty()) {
+		frame.path.vertices.front() = planet;
+	}
+	const Geometry::World& world = frame.world;
+	const std::optional<ptrdiff_t>& selectedIndex = frame.selectedIndex;
+	const std::vector<Geometry::Vector2<float>>& currentShape = frame.currentShape;
+	const Geometry::Vector2<float>& lastKnownValidVertex = frame.lastKnownValidVertex;
+	const Geometry::LineSequence& path = frame.path;
+
+	if (screen && !frame.title.empty() && frame.title != shownTitle) {
+		screen->UpdateTitle(frame.title);
+		shownTitle = frame.title;
+	}
+
+	renderer.SetCamera(camera);
+
+	// World, of which only the polygons on screen are batched, and only once it, the selection or the camera has changed.
+	// Everything after it changes from frame to frame, so it is drawn over the static layer every frame.
+	// While the camera moves, the batch changes every frame, and drawing it into the static layer only to copy that to the
+	// screen costs more than drawing it directly. The layer is drawn again once the camera comes to rest.
+	const WorldBatchKey key{ world->version, selectedIndex, camera };
+	bool cameraMoved = false;
+	if (worldBatchKey != key) {
+		cameraMoved = worldBatchKey && worldBatchKey->camera != camera;
+		const auto [viewMin, viewMax] = Geometry::Viewport(camera);
+		visiblePolygons.clear();
+		frame.drawing->grid.Query(viewMin, viewMax, visiblePolygons);
+
+		// Polygons only a few pixels across are drawn with fewer vertices, or none of their own
+		worldBatch.Clear();
+		const float pixelsPerUnit = static_cast<float>(Constants::PIXELS_PER_UNIT.x) * camera.zoom;
+		for (size_t index : visiblePolygons) {
+			const Geometry::Polygon& polygon = world->polygons[index];
+			const Geometry::DetailLevels& detail = frame.drawing->detail[index];
+			const Color& color = selectedIndex.has_value() && static_cast<ptrdiff_t>(index) == selectedIndex ? Color::PINK : Color::RED;
+			switch (const Geometry::Detail chosen = Geometry::ChooseDetail(polygon, detail, pixelsPerUnit); chosen.kind) {
+			case Geometry::Detail::Kind::POINT:
+				worldBatch.AddPoint((detail.min + detail.max) * 0.5f, color, camera);
+				break;
+			case Geometry::Detail::Kind::QUAD:
+				worldBatch.AddQuad(detail.min, detail.max, color, camera);
+				break;
+			case Geometry::Detail::Kind::POLYGON:
+				if (!worldBatch.Add(*chosen.polygon, color, camera)) return false;
+				break;
+			}
+		}
+		worldBatchKey = key;
+		renderer.InvalidateStaticLayer();
 	}
+	if (!(cameraMoved ? renderer.RenderPolygons(worldBatch) : renderer.RenderStaticLayer(worldBatch))) return false;
 	if (currentShape.size() == 1) {
 		if (!renderer.RenderLine(Geometry::Line{ currentShape.front(), lastKnownValidVertex }, Color::PINK)) return false;
 	}
 	if (currentShape.size() > 1) {
-		Geometry::Polygon polygon{ currentShape };
-		polygon.vertices.push_back(lastKnownValidVertex);
-		if (!renderer.RenderPolygon(polygon, Color::PINK)) return false;
+		shapePreview.vertices.assign(currentShape.begin(), currentShape.end());
+		shapePreview.vertices.push_back(lastKnownValidVertex);
+		if (!renderer.RenderPolygon(shapePreview, Color::PINK)) return false;
 	}
 
 
@@ -127,15 +374,33 @@ bool Application::OnRender(SDLWrapper::Screen::Renderer& renderer) NOEXCEPT_IF_N
 }
 
 bool Application::OnKeyPressed(SDLWrapper::Keyboard::KeyCode key) noexcept {
+	std::lock_guard lock(inputMutex);
+	pendingInput.push_back({ Input::Kind::KEY, key, {}, MousePosition() });
+	return true;
+}
+
+bool Application::OnMouseClicked(SDLWrapper::Mouse::Button button) noexcept {
+	std::lock_guard lock(inputMutex);
+	pendingInput.push_back({ Input::Kind::CLICK, {}, button, MousePosition() });
+	return true;
+}
+
+void Application::HandleKey(SDLWrapper::Keyboard::KeyCode key) noexcept {
 	switch (key) {
 	case SDLWrapper::Keyboard::KeyCode::RETURN:
 		if (currentShape.size() > 2) {
 			Geometry::Polygon polygon{ std::move(currentShape) };
 			if (!Geometry::InPolygon(polygon, planet) && (path.vertices.empty() || !Geometry::InPolygon(polygon, path.vertices.back()))) {
-				world.push_back(Geometry::Polygon{ polygon });
+				world = Geometry::Modify(world, [&polygon](auto& polygons) { polygons.push_back(polygon); });
+				if (hierarchicalPlanner) {
+					hierarchicalPlanner->AddPolygon(world);
+				}
 				if (!path.vertices.empty()) {
-					path = AStar::FindPath(world, planet, path.vertices.back());
-					velocityUnit = (path.vertices[1] - path.vertices[0]).Unit();
+					path = FindPath(path.vertices.back());
+					if (path.vertices.size() > 1) {
+						velocityUnit = (path.vertices[1] - path.vertices[0]).Unit();
+					}
+					UpdateTitle();
 				}
 			}
 		}
@@ -152,60 +417,207 @@ bool Application::OnKeyPressed(SDLWrapper::Keyboard::KeyCode key) noexcept {
 
 	case SDLWrapper::Keyboard::KeyCode::DELETE:
 		if (selectedIndex.has_value()) {
-			world.erase(world.begin() + selectedIndex.value());
+			world = Geometry::Modify(world, [this](auto& polygons) { polygons.erase(polygons.begin() + selectedIndex.value()); });
+			if (hierarchicalPlanner) {
+				hierarchicalPlanner->RemovePolygon(world, static_cast<size_t>(selectedIndex.value()));
+			}
 			selectedIndex.reset();
 		}
 		break;
+	case SDLWrapper::Keyboard::KeyCode::G: {
+		// Replace the world with a generated one, with the planet somewhere free in it
+		Geometry::WorldParameters parameters;
+		parameters.layout = static_cast<Geometry::WorldParameters::Layout>(generatedWorlds % static_cast<size_t>(Geometry::WorldParameters::Layout::LAYOUT_COUNT));
+		parameters.polygonCount = Constants::GENERATED_POLYGON_COUNT;
+		parameters.seed = static_cast<uint32_t>(generatedWorlds++);
+		world = Geometry::Publish(Geometry::GenerateWorld(parameters));
+		planet = Geometry::GenerateFreePositions(world->polygons, 1, parameters.seed).front();
+		path.vertices.clear();
+		velocityUnit = { 0.0f, 0.0f };
+		currentShape.clear();
+		direction = Geometry::RotationalDirection::UNDEFINED;
+		selectedIndex.reset();
+		hierarchicalPlanner.reset();
+		break;
+	}
 	case SDLWrapper::Keyboard::KeyCode::UP:
 		AStar::AddThread();
-		screen->UpdateTitle(std::to_string(AStar::ThreadCount()) + " threads running A*");
+		UpdateTitle();
 		break;
 	case SDLWrapper::Keyboard::KeyCode::DOWN:
 		AStar::RemoveThread();
-		screen->UpdateTitle(std::to_string(AStar::ThreadCount()) + " threads running A*");
+		UpdateTitle();
+		break;
+	case SDLWrapper::Keyboard::KeyCode::L:
+		AStar::UseLandmarks(AStar::LandmarkCount() ? 0 : Constants::LANDMARK_COUNT);
+		UpdateTitle();
+		break;
+	case SDLWrapper::Keyboard::KeyCode::X:
+		AStar::ExpandInParallel(!AStar::ExpandsInParallel());
+		UpdateTitle();
+		break;
+	case SDLWrapper::Keyboard::KeyCode::M:
+		AStar::UseRelaxedFringe(!AStar::UsesRelaxedFringe());
+		UpdateTitle();
+		break;
+	case SDLWrapper::Keyboard::KeyCode::T:
+		AStar::AdaptThreadCount(!AStar::AdaptsThreadCount());
+		UpdateTitle();
+		break;
+	case SDLWrapper::Keyboard::KeyCode::I:
+		collectStatistics = !collectStatistics;
+		lastSearch = {};
+		UpdateTitle();
+		break;
+	case SDLWrapper::Keyboard::KeyCode::P:
+		planner = static_cast<Planner>((static_cast<int>(planner) + 1) % static_cast<int>(Planner::PLANNER_COUNT));
+		lastSearch = {};
+		UpdateTitle();
 		break;
 	default:
 		break;
 	}
-	return true;
 }
 
-bool Application::OnMouseClicked(SDLWrapper::Mouse::Button button) noexcept {
+void Application::HandleClick(SDLWrapper::Mouse::Button button, const Geometry::Vector2<float>& position) noexcept {
 	if (button == SDLWrapper::Mouse::Button::LEFT) {
-		auto selected = Geometry::InPolygon(world, Geometry::ScreenToWorld(SDLWrapper::Mouse::GetPosition()));
-		if (selected != world.end()) {
-			selectedIndex = selected - world.begin();
+		auto selected = Geometry::InPolygon(world->polygons, position);
+		if (selected != world->polygons.end()) {
+			selectedIndex = selected - world->polygons.begin();
 			currentShape.clear();
 			direction = Geometry::RotationalDirection::UNDEFINED;
 		}
 		else {
 			selectedIndex.reset();
-			if (ValidNextVertex(Geometry::ScreenToWorld(SDLWrapper::Mouse::GetPosition()))) {
+			if (ValidNextVertex(position)) {
 
 				// If we create a triangle, we know which direction vertices are ordered and can store it to enforce it
 				if (currentShape.size() == 2) {
 					direction = Geometry::DirectionOfAngle(currentShape[0], currentShape[1],
-						Geometry::ScreenToWorld(SDLWrapper::Mouse::GetPosition()));
+						position);
 					if (direction == Geometry::RotationalDirection::CLOCKWISE ||
 						direction == Geometry::RotationalDirection::COUNTERCLOCKWISE) {
 						// Ensure that polygon has area and is valid
-						currentShape.push_back(Geometry::ScreenToWorld(SDLWrapper::Mouse::GetPosition()));
+						currentShape.push_back(position);
 					}
 				}
 				else {
-					currentShape.push_back(Geometry::ScreenToWorld(SDLWrapper::Mouse::GetPosition()));
+					currentShape.push_back(position);
 				}
 			}
 		}
 	}
 
 	if (button == SDLWrapper::Mouse::Button::RIGHT) {
-		if (Geometry::InPolygon(world, Geometry::ScreenToWorld(SDLWrapper::Mouse::GetPosition())) == world.end()) {
-			path = AStar::FindPath(world, planet, Geometry::ScreenToWorld(SDLWrapper::Mouse::GetPosition()));
-			velocityUnit = (path.vertices[1] - path.vertices[0]).Unit();
+		if (Geometry::InPolygon(world->polygons, position) == world->polygons.end()) {
+			// A goal may be shut off from the planet by polygons around it, in which case there is no path to it
+			path = FindPath(position);
+			if (path.vertices.size() > 1) {
+				velocityUnit = (path.vertices[1] - path.vertices[0]).Unit();
+			}
+			UpdateTitle();
 		}
 	}
-	return true;
+}
+
+Geometry::LineSequence Application::FindPath(const Geometry::Vector2<float>& goal) NOEXCEPT_IF_NOT_DEBUG {
+	switch (planner) {
+	case Planner::CONTRACTION_HIERARCHY:
+		if (!contractionHierarchy || contractionHierarchy->Version() != world->version) {
+			contractionHierarchy.emplace(Prepared());
+		}
+		return contractionHierarchy->FindPath(planet, goal);
+	case Planner::GOAL_TREE:
+		if (!goalTree || goalTree->Version() != world->version || goalTree->Goal() != goal) {
+			goalTree.emplace(Prepared(), goal);
+		}
+		return goalTree->FindPath(planet);
+	case Planner::SHORTEST_PATH_MAP: {
+		std::shared_ptr<const AStar::ShortestPathMap> map;
+		{
+			std::lock_guard lock(shortestPathMapMutex);
+			map = shortestPathMap;
+		}
+		if (map && map->Version() == world->version && map->Goal() == goal) {
+			return map->FindPath(planet);
+		}
+		if (shortestPathMapBuilding != std::pair{ world->version, goal }) {
+			shortestPathMapBuilding.emplace(world->version, goal);
+			shortestPathMapBuild = std::jthread([this, world = world, goal](std::stop_token stop) {
+				auto built = std::make_shared<const AStar::ShortestPathMap>(Geometry::Prepare(world), goal,
+					Constants::SHORTEST_PATH_MAP_RESOLUTION, Constants::SHORTEST_PATH_MAP_MAX_REGIONS, stop);
+				if (!stop.stop_requested()) {
+					std::lock_guard lock(shortestPathMapMutex);
+					shortestPathMap = std::move(built);
+				}
+			});
+		}
+		return AStar::FindPath(world, planet, goal, collectStatistics ? &lastSearch : nullptr);
+	}
+	case Planner::HIERARCHICAL:
+		if (!hierarchicalPlanner) {
+			hierarchicalPlanner.emplace(world);
+		}
+		return hierarchicalPlanner->FindPath(planet, goal);
+	default:
+		return AStar::FindPath(world, planet, goal, collectStatistics ? &lastSearch : nullptr);
+	}
+}
+
+std::shared_ptr<const Geometry::PreparedWorld> Application::Prepared() NOEXCEPT_IF_NOT_DEBUG {
+	auto prepared = preparedWorld.load();
+	if (!prepared || prepared->Version() != world->version) {
+		prepared = Geometry::Prepare(world);
+		preparedWorld.store(prepared);
+	}
+	return prepared;
+}
+
+void Application::UpdateTitle() NOEXCEPT_IF_NOT_DEBUG {
+	switch (planner) {
+	case Planner::CONTRACTION_HIERARCHY:
+		title = "contraction hierarchy";
+		break;
+	case Planner::GOAL_TREE:
+		title = "shortest path tree to the goal";
+		break;
+	case Planner::SHORTEST_PATH_MAP:
+		title = "shortest path map to the goal";
+		if (std::lock_guard lock(shortestPathMapMutex); shortestPathMap) {
+			title += " (" + std::to_string(shortestPathMap->RegionCount()) + " regions)";
+		}
+		break;
+	case Planner::HIERARCHICAL:
+		title = "hierarchical pathfinding";
+		break;
+	default:
+		title = (AStar::AdaptsThreadCount() ? "up to " : "") + std::to_string(AStar::ThreadCount())
+			+ (AStar::ExpandsInParallel() ? " threads expanding A*" : " threads running A*");
+		if (AStar::LandmarkCount()) {
+			title += " with " + std::to_string(AStar::LandmarkCount()) + " landmarks";
+		}
+		if (AStar::UsesRelaxedFringe()) {
+			title += " on a relaxed fringe";
+		}
+		if (AStar::AdaptsThreadCount()) {
+			title += " (last used " + std::to_string(AStar::LastThreadCount()) + ")";
+		}
+		if (collectStatistics && lastSearch.nodesPopped > 0) {
+			using std::chrono::microseconds, std::chrono::duration_cast;
+			std::chrono::nanoseconds busy{}, total{};
+			for (const AStar::SolveStatistics::Thread& thread : lastSearch.threads) {
+				busy += thread.busy;
+				total += thread.busy + thread.idle;
+			}
+			title += " | last A* search " + std::to_string(lastSearch.nodesPopped) + " nodes, "
+				+ std::to_string(lastSearch.reopenings) + " reopened, "
+				+ std::to_string(lastSearch.polygonTests) + " polygon tests ("
+				+ std::to_string(lastSearch.polygonTests ? 100 * lastSearch.earlyRejections / lastSearch.polygonTests : 0) + "% early), "
+				+ std::to_string(duration_cast<microseconds>(lastSearch.fringeWait + lastSearch.discoveredWait).count()) + " us waiting, "
+				+ std::to_string(total.count() ? 100 * busy.count() / total.count() : 0) + "% busy";
+		}
+		break;
+	}
 }
 
 void Application::OnRendererDestroyed() {
@@ -218,41 +630,4 @@ void Application::OnKeyboardDestroyed() {
 
 void Application::OnMouseDestroyed() {
 	mouse = nullptr;
-}
-
-Application::Application(Application&& other) noexcept {
-	if (other.screen) {
-		other.screen->DetachFromRenderEvent(&other);
-		screen = std::exchange(other.screen, nullptr);
-		screen->SubscribeToRenderEvent(this);
-	}
-	if (other.keyboard) {
-		other.keyboard->DetachFromPressEvent(&other);
-		keyboard = std::exchange(other.keyboard, nullptr);
-		keyboard->SubscribeToPressEvent(this);
-	}
-	if (other.mouse) {
-		other.mouse->DetachFromClickEvent(&other);
-		mouse = std::exchange(other.mouse, nullptr);
-		mouse->DetachFromClickEvent(this);
-	}
-}
-
-Application& Application::operator=(Application&& other) noexcept{
-	if (other.screen) {
-		other.screen->DetachFromRenderEvent(&other);
-		screen = std::exchange(other.screen, nullptr);
-		screen->SubscribeToRenderEvent(this);
-	}
-	if (other.keyboard) {
-		other.keyboard->DetachFromPressEvent(&other);
-		keyboard = std::exchange(other.keyboard, nullptr);
-		keyboard->SubscribeToPressEvent(this);
-	}
-	if (other.mouse) {
-		other.mouse->DetachFromClickEvent(&other);
-		mouse = std::exchange(other.mouse, nullptr);
-		mouse->DetachFromClickEvent(this);
-	}
-	return *this;
 }
\ No newline at end of file
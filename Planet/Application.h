@@ -2,7 +2,23 @@
 
 #include "SDLWrapper.h"
 #include "AStar.h"
+#include "ContractionHierarchy.h"
+#include "GoalTree.h"
+#include "ShortestPathMap.h"
+#include "HierarchicalPlanner.h"
+#include "SpatialGrid.h"
+#include "LevelOfDetail.h"
+#include "InputScript.h"
+#include "WorldGenerator.h"
 #include <optional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <string>
+#include <bitset>
 
 class Application final :
 	public SDLWrapper::BaseRenderObserver,
@@ -16,11 +32,38 @@ class Application final :
 	SDLWrapper::Mouse*       mouse = nullptr;
 
 	// Polygon drawing and interaction
-	std::vector<Geometry::Polygon> world;
+	Geometry::World world = Geometry::Publish({}); // Edits publish a new snapshot, so anything holding the old one is unaffected
 	std::vector<Geometry::Vector2<float>> currentShape;
 	std::optional<ptrdiff_t> selectedIndex;
 	Geometry::Vector2<float> lastKnownValidVertex;
 	Geometry::RotationalDirection direction = Geometry::RotationalDirection::UNDEFINED;
+	Geometry::Polygon shapePreview; // The current shape closed at the mouse, kept between frames to reuse its memory
+	size_t generatedWorlds = 0; // Each generated world is of the layout after the last, and seeded by how many came before
+
+	// The view into the world, moved with WASD and zoomed with Q and E
+	Geometry::Camera camera;
+
+	// The polygons on screen drawn as one batch into the renderer's static layer, and what it was built for
+	struct WorldBatchKey {
+		size_t version;
+		std::optional<ptrdiff_t> selectedIndex;
+		Geometry::Camera camera;
+
+		[[nodiscard]] friend bool operator==(const WorldBatchKey&, const WorldBatchKey&) = default;
+	};
+	SDLWrapper::PolygonBatch worldBatch;
+	std::optional<WorldBatchKey> worldBatchKey;
+
+	// Finds the polygons on screen without going through all of them, along with the simplified levels each polygon is
+	// drawn with when zoomed out. Built by the simulation whenever the world changes and handed over with its frames, so that
+	// the render thread never waits on the pool.
+	struct WorldDrawing {
+		size_t version;
+		Geometry::SpatialGrid grid;
+		std::vector<Geometry::DetailLevels> detail;
+	};
+	std::shared_ptr<const WorldDrawing> worldDrawing; // Of the world the simulation last published
+	std::vector<size_t> visiblePolygons;
 
 
 	// The path finding entity
@@ -28,12 +71,123 @@ class Application final :
 	Geometry::LineSequence path;
 	Geometry::Vector2<float> velocityUnit; // Cache the unit velocity so we don't need to do more sqrts than necessary
 
+	// Everything derived from the world, prepared in parallel on first use and published whole,
+	// so that whoever loads it sees one consistent preparation
+	std::atomic<std::shared_ptr<const Geometry::PreparedWorld>> preparedWorld;
+
+	// Returns the prepared world, preparing it first if it is not of the current version
+	std::shared_ptr<const Geometry::PreparedWorld> Prepared() NOEXCEPT_IF_NOT_DEBUG;
+
+	// How paths are found. The precomputed planners are built on first use and rebuilt when used in a newer version of the world.
+	enum class Planner { SEARCH, CONTRACTION_HIERARCHY, GOAL_TREE, SHORTEST_PATH_MAP, HIERARCHICAL, PLANNER_COUNT } planner = Planner::SEARCH;
+	std::optional<AStar::ContractionHierarchy> contractionHierarchy;
+	std::optional<AStar::GoalTree> goalTree; // Also rebuilt when the goal moves
+	std::optional<AStar::HierarchicalPlanner> hierarchicalPlanner; // Kept through edits, which it mirrors
+
+	// The shortest path map takes far too long to build between steps, so it is built on a thread of its own while A*
+	// answers in its place. Starting a build for another goal or world stops the one before, which is then thrown away.
+	std::mutex shortestPathMapMutex;
+	std::shared_ptr<const AStar::ShortestPathMap> shortestPathMap; // The last one built, guarded by the mutex
+	std::optional<std::pair<size_t, Geometry::Vector2<float>>> shortestPathMapBuilding; // The version and goal of the last build started
+	std::jthread shortestPathMapBuild;
+
+	// Finds a path from the planet to goal with the current planner
+	Geometry::LineSequence FindPath(const Geometry::Vector2<float>& goal) NOEXCEPT_IF_NOT_DEBUG;
+
+	// Statistics slow every search a little, so A* only collects them while they are shown
+	bool collectStatistics = false;
+	AStar::SolveStatistics lastSearch; // Of the last path found by A* while collecting, which the title sums up. Cleared when the planner changes.
+
 
 	// Checks whether the passed vertex is valid. Currentshape should not overlap any polygons in world and should be convex, if it is a polygon.
 	bool ValidNextVertex(const Geometry::Vector2<float> vertex) noexcept;
 
+	// Shows the current solver settings, and how hard the last search worked, in the window title once the render thread gets to it
+	void UpdateTitle() NOEXCEPT_IF_NOT_DEBUG;
+	std::string title, shownTitle;
+
+
+	// Input arrives on the main thread, where it is queued for the simulation to handle at its next step. Whatever lasts as
+	// long as it is held, rather than happening once, is sampled every frame instead.
+	struct Input {
+		enum class Kind { KEY, CLICK } kind;
+		SDLWrapper::Keyboard::KeyCode key = SDLWrapper::Keyboard::KeyCode::NOT_SUPPORTED;
+		SDLWrapper::Mouse::Button button = SDLWrapper::Mouse::Button::LEFT;
+		Geometry::Vector2<int> mousePosition;
+	};
+	struct HeldInput {
+		Geometry::Vector2<int> mousePosition;
+		std::bitset<static_cast<size_t>(SDLWrapper::Keyboard::KeyCode::KEYBOARD_SIZE)> keys; // Only those that do anything when held
+		[[nodiscard]] bool IsPressed(SDLWrapper::Keyboard::KeyCode key) const noexcept { return keys.test(static_cast<size_t>(key)); }
+	};
+	std::mutex inputMutex;
+	std::vector<Input> pendingInput, handledInput;
+	HeldInput heldInput;
+	size_t stepCount = 0; // Steps taken, counted when their input is taken
+	Geometry::Vector2<int> MousePosition() const noexcept;
+
+	// While recording, the input each step takes is written down as a script that plays it back. The script is of what the
+	// simulation took rather than of what the user did, so that played back headless, it takes each step the same input.
+	std::optional<std::vector<SDLWrapper::InputScript::Event>> recording;
+	size_t recordingStart = 0;
+	HeldInput recordedHeld;
+	void Record(size_t step, const HeldInput& held);
+
+	void HandleKey(SDLWrapper::Keyboard::KeyCode key) noexcept;
+	void HandleClick(SDLWrapper::Mouse::Button button, const Geometry::Vector2<float>& position) noexcept;
+
+	// Advances the simulation by deltaTime
+	void Step(std::chrono::duration<float> deltaTime, const HeldInput& held) noexcept;
+
+
+	// What the simulation shows after a step, for the render thread to draw
+	struct Frame {
+		std::chrono::steady_clock::time_point time;
+		Geometry::World world;
+		std::shared_ptr<const WorldDrawing> drawing; // Of world
+		std::optional<ptrdiff_t> selectedIndex;
+		std::vector<Geometry::Vector2<float>> currentShape;
+		Geometry::Vector2<float> lastKnownValidVertex;
+		Geometry::Vector2<float> planet;
+		Geometry::LineSequence path;
+		Geometry::Camera camera;
+		std::string title;
+	};
+
+	// Steps are written into the back frame, which is then rotated in as the latest, so that the render thread always has
+	// the two latest steps to interpolate between. Either thread only ever waits for the other to rotate or copy frames.
+	std::mutex frameMutex;
+	Frame previousFrame, latestFrame, backFrame;
+	void Publish(std::chrono::steady_clock::time_point time);
+
+	// The render thread's copies of the frames, kept between frames to reuse their memory
+	Frame renderedPrevious, renderedLatest;
+
+	// Steps the simulation at a fixed rate on a thread of its own, so that it neither waits for the display nor holds up
+	// rendering while it solves. Declared last, so that everything it uses is constructed before it starts.
+	std::atomic<bool> simulating{ true };
+	std::exception_ptr simulationFailure;
+	void Simulate(std::stop_token stop) noexcept;
+	std::jthread simulation;
+
 public:
-	bool Update(std::chrono::duration<float> deltaTime) noexcept;
+	// Samples the input that is held rather than pressed, to be called once per frame on the main thread
+	void SampleInput() noexcept;
+
+	// Whether the application steps itself in real time on a thread of its own, or only when Advance is called, as fast as
+	// whoever calls it likes. The latter runs headless simulations and benchmarks, which care for neither frames nor real time.
+	enum class Stepping { REAL_TIME, MANUAL };
+
+	// Handles the input since the last step and takes one step, on the calling thread. Only for manual stepping.
+	void Advance() noexcept;
+
+	// How many steps have taken their input, which is the step that input arriving now is handled at
+	[[nodiscard]] size_t StepCount() noexcept;
+
+	// Records the input of the steps from now until StopRecording, which returns it as a script counting steps from the start
+	void StartRecording();
+	[[nodiscard]] SDLWrapper::InputScript StopRecording();
+
 	bool OnRender(SDLWrapper::Screen::Renderer& renderer) NOEXCEPT_IF_NOT_DEBUG override;
 	bool OnKeyPressed(SDLWrapper::Keyboard::KeyCode key)  noexcept override;
 	bool OnMouseClicked(SDLWrapper::Mouse::Button button) noexcept override;
@@ -42,10 +196,12 @@ public:
 	void OnKeyboardDestroyed() override;
 	void OnMouseDestroyed()    override;
 
-	Application(SDLWrapper::Screen& screen, SDLWrapper::Keyboard& keyboard, SDLWrapper::Mouse& mouse);
+	Application(SDLWrapper::Screen& screen, SDLWrapper::Keyboard& keyboard, SDLWrapper::Mouse& mouse, Stepping stepping = Stepping::REAL_TIME);
 	~Application() noexcept;
-	Application(Application&& other) noexcept;
-	Application& operator=(Application&& other) noexcept;
+
+	// The simulation thread refers to the application, which therefore stays where it is
+	Application(Application&& other) = delete;
+	Application& operator=(Application&& other) = delete;
 	Application(const Application&) = delete;
 	Application& operator=(const Application) = delete;
 };
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "Arena.h"
+#include <algorithm>
+
+namespace AStar {
+
+	void* Arena::CountingResource::do_allocate(size_t bytes, size_t alignment) {
+		void* pointer = upstream->allocate(bytes, alignment);
+		used += bytes;
+		return pointer;
+	}
+
+	void Arena::CountingResource::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+		upstream->deallocate(pointer, bytes, alignment);
+	}
+
+	bool Arena::CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+		return this == &other;
+	}
+
+	Arena::Arena(size_t initialCapacity) :
+		buffer(std::make_unique<std::byte[]>(initialCapacity)),
+		capacity(initialCapacity),
+		monotonic(std::in_place, buffer.get(), capacity, std::pmr::new_delete_resource()),
+		counting(&*monotonic)
+	{
+		pool.emplace(&counting);
+	}
+
+	void Arena::Reset() {
+		// The pool gives its chunks back to the buffer, which takes them back all at once
+		pool.reset();
+		peak = std::max(peak, counting.used);
+
+		// Leave some room for the padding that aligning the chunks costs
+		if (counting.used > capacity) {
+			monotonic.reset();
+			capacity = counting.used + counting.used / 4;
+			buffer = std::make_unique<std::byte[]>(capacity);
+			monotonic.emplace(buffer.get(), capacity, std::pmr::new_delete_resource());
+		}
+		else {
+			monotonic->release();
+		}
+		counting.used = 0;
+		pool.emplace(&counting);
+	}
+}
\ No newline at end of file
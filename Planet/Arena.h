@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory_resource>
+#include <memory>
+#include <optional>
+#include <cstddef>
+
+namespace AStar {
+
+	// The memory of a solve. Everything is carved out of one buffer and given back all at once by Reset, rather than freed
+	// piece by piece. Memory freed during a solve is pooled for reuse, so that short lived paths do not use the buffer up.
+	// Whenever a solve needs more than the buffer holds, the overflow comes from the global heap and the buffer is grown to
+	// match at the next Reset, so that once the buffer has seen the largest solve, solves no longer touch the global heap.
+	class Arena {
+
+		// Counts the bytes taken from the buffer, which only grows until Reset since the buffer never takes anything back
+		class CountingResource : public std::pmr::memory_resource {
+			std::pmr::memory_resource* upstream;
+			size_t used = 0;
+			friend class Arena;
+
+		public:
+			explicit CountingResource(std::pmr::memory_resource* upstream) noexcept : upstream(upstream) {}
+
+		private:
+			void* do_allocate(size_t bytes, size_t alignment) override;
+			void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+		};
+
+		std::unique_ptr<std::byte[]> buffer;
+		size_t capacity = 0;
+		size_t peak = 0;
+
+		std::optional<std::pmr::monotonic_buffer_resource> monotonic;
+		CountingResource counting;
+
+		// Rebuilt on every Reset, since the pool keeps some bookkeeping of its own even when released
+		std::optional<std::pmr::synchronized_pool_resource> pool;
+
+	public:
+		explicit Arena(size_t initialCapacity = 1 << 16);
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		// Threadsafe, and valid until the next Reset
+		[[nodiscard]] std::pmr::memory_resource* Resource() noexcept { return &*pool; }
+
+		// Takes back everything allocated since the last Reset. Nothing allocated from Resource() may be used, or freed, after this.
+		void Reset();
+
+		// The most a solve has taken from the arena, and how much it holds without going to the global heap, in bytes
+		[[nodiscard]] size_t Peak() const noexcept { return peak; }
+		[[nodiscard]] size_t Capacity() const noexcept { return capacity; }
+	};
+}
\ No newline at end of file
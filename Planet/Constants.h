@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <chrono>
 #include "Vector2.h"
 
 namespace Constants {
@@ -21,11 +22,59 @@ namespace Constants {
 		static_cast<float>(WINDOW_DIMENSIONS.y) * 0.5f / static_cast<float>(PIXELS_PER_UNIT.y) 
 	};
 
+	// How fast the camera pans, in world space units per second at a zoom of 1, and by what factor it zooms per second
+	constexpr float CAMERA_PAN_SPEED = 4.0f;
+	constexpr float CAMERA_ZOOM_RATE = 2.0f;
+
+	// How far the camera may zoom out and in
+	constexpr float CAMERA_MIN_ZOOM = 1.0f / 64.0f;
+	constexpr float CAMERA_MAX_ZOOM = 16.0f;
+
+	// The side of the grid cells used to find the polygons on screen, in world space units
+	constexpr float CULLING_CELL_SIZE = 1.0f;
+
+	// Polygons are drawn with at most one vertex for every so many pixels they span, and once they span fewer pixels than
+	// these, as their bounding box or as a single pixel
+	constexpr float PIXELS_PER_DETAIL_VERTEX = 6.0f;
+	constexpr float QUAD_IMPOSTOR_PIXELS = 4.0f;
+	constexpr float POINT_IMPOSTOR_PIXELS = 1.5f;
+
 	// Application
 
 	// How fast the planet traverses its path, in world space units per second
 	constexpr float PLANET_SPEED = 1.5f;
 
+	// How long each step of the simulation is, whatever the display's refresh rate
+	constexpr std::chrono::duration<float> SIMULATION_STEP{ 1.0f / 120.0f };
+
+	// How far the simulation may fall behind before it skips steps instead of catching up
+	constexpr std::chrono::duration<float> MAX_SIMULATION_LAG{ 0.25f };
+
+	// Pathfinding
+
+	// How many landmarks the ALT heuristic uses when it is toggled on
+	constexpr size_t LANDMARK_COUNT = 8;
+
+	// The smallest region a shortest path map divides space into, in world space units
+	constexpr float SHORTEST_PATH_MAP_RESOLUTION = 0.05f;
+
+	// How many regions a shortest path map may divide space into. Each costs five queries to the shortest path tree to build.
+	constexpr size_t SHORTEST_PATH_MAP_MAX_REGIONS = 1 << 16;
+
+	// The side of the square clusters hierarchical pathfinding divides the world into, in world space units. Larger clusters
+	// leave fewer entrances to search, but take longer to build and to link the start and goal into.
+	constexpr float CLUSTER_SIZE = 4.0f;
+
+	// The most space between two entrances along the same uncovered stretch of a cluster's side, in world space units.
+	// Paths are led at most about half this out of their way where they cross a side.
+	constexpr float CLUSTER_ENTRANCE_SPACING = 0.25f;
+
+	// How many heaps per searching thread a relaxed fringe spreads its nodes over
+	constexpr size_t HEAPS_PER_THREAD = 2;
+
+	// How many polygons there are in the worlds generated at the press of G
+	constexpr size_t GENERATED_POLYGON_COUNT = 256;
+
 	// Geometry
 
 	// Accepted error term to compensate for floating point inaccuracy in intersect predicates
@@ -0,0 +1,233 @@
+#include "ContractionHierarchy.h"
+#include <algorithm>
+#include <queue>
+
+namespace AStar {
+
+	namespace {
+		using Entry = std::pair<float, size_t>;
+		using MinQueue = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+		// How many vertices a witness search may settle before giving up. Giving up only adds a superfluous shortcut.
+		constexpr size_t WITNESS_SETTLE_LIMIT = 32;
+	}
+
+	ContractionHierarchy::ContractionHierarchy(const std::vector<Geometry::Polygon>& world) NOEXCEPT_IF_NOT_DEBUG :
+		ContractionHierarchy(Geometry::Prepare(Geometry::Publish(world))) {}
+
+	ContractionHierarchy::ContractionHierarchy(std::shared_ptr<const Geometry::PreparedWorld> prepared) NOEXCEPT_IF_NOT_DEBUG :
+		prepared(std::move(prepared)),
+		upward(this->prepared->graph.vertices.size()) {
+
+		const Geometry::VisibilityGraph& graph = this->prepared->graph;
+		constexpr size_t NO_VERTEX = Geometry::VisibilityGraph::NO_VERTEX;
+		const size_t count = graph.vertices.size();
+
+		// The graph that is left to contract, which gains shortcuts as vertices are removed from it
+		std::vector<std::vector<Arc>> remaining(count);
+		for (size_t vertex = 0; vertex < count; ++vertex) {
+			for (const auto& edge : graph.edges[vertex]) {
+				remaining[vertex].push_back({ edge.to, edge.length, NO_VERTEX });
+			}
+		}
+		std::vector<bool> contracted(count, false);
+		std::vector<int> contractedNeighbours(count, 0);
+
+		// Adds arc to arcs, unless there already is a shorter one to the same vertex
+		auto addArc = [](std::vector<Arc>& arcs, const Arc& arc) {
+			auto found = std::ranges::find(arcs, arc.to, &Arc::to);
+			if (found == arcs.end()) {
+				arcs.push_back(arc);
+			}
+			else if (arc.length < found->length) {
+				*found = arc;
+			}
+		};
+
+		// Returns the shortcuts needed to contract vertex, as pairs of the vertex each shortcut leaves from and the arc itself.
+		// A shortcut is needed between two neighbours unless a witness path that avoids vertex is at least as short.
+		auto shortcuts = [&](size_t vertex) {
+			std::vector<std::pair<size_t, Arc>> needed;
+			const auto& neighbours = remaining[vertex];
+			for (auto from = neighbours.begin(); from != neighbours.end(); ++from) {
+				if (std::next(from) == neighbours.end()) {
+					break;
+				}
+				float limit = 0.0f;
+				for (auto to = std::next(from); to != neighbours.end(); ++to) {
+					limit = std::max(limit, from->length + to->length);
+				}
+
+				// Bounded Dijkstra from one neighbour, which may not pass through vertex
+				std::unordered_map<size_t, float> distances{ { from->to, 0.0f } };
+				MinQueue fringe;
+				fringe.push({ 0.0f, from->to });
+				size_t settled = 0;
+				while (!fringe.empty() && settled < WITNESS_SETTLE_LIMIT) {
+					const auto [distance, current] = fringe.top();
+					fringe.pop();
+					if (distance > distances[current]) {
+						continue;
+					}
+					if (distance > limit) {
+						break;
+					}
+					++settled;
+					for (const auto& arc : remaining[current]) {
+						if (arc.to == vertex) {
+							continue;
+						}
+						auto found = distances.find(arc.to);
+						if (found == distances.end() || distance + arc.length < found->second) {
+							distances[arc.to] = distance + arc.length;
+							fringe.push({ distance + arc.length, arc.to });
+						}
+					}
+				}
+
+				for (auto to = std::next(from); to != neighbours.end(); ++to) {
+					const float via = from->length + to->length;
+					auto witness = distances.find(to->to);
+					if (witness == distances.end() || witness->second > via) {
+						needed.push_back({ from->to, Arc{ to->to, via, vertex } });
+					}
+				}
+			}
+			return needed;
+		};
+
+		// The edge difference, which prefers contracting vertices that add few shortcuts and whose neighbours are not yet contracted
+		auto priority = [&](size_t vertex, size_t shortcutCount) {
+			return static_cast<float>(shortcutCount) - static_cast<float>(remaining[vertex].size())
+				+ static_cast<float>(contractedNeighbours[vertex]);
+		};
+
+		MinQueue order;
+		for (size_t vertex = 0; vertex < count; ++vertex) {
+			order.push({ priority(vertex, shortcuts(vertex).size()), vertex });
+		}
+
+		while (!order.empty()) {
+			const size_t vertex = order.top().second;
+			order.pop();
+			if (contracted[vertex]) {
+				continue;
+			}
+
+			// Priorities go stale as neighbours are contracted, so recompute lazily and defer the vertex if it is no longer the best
+			const auto needed = shortcuts(vertex);
+			const float current = priority(vertex, needed.size());
+			if (!order.empty() && current > order.top().first) {
+				order.push({ current, vertex });
+				continue;
+			}
+
+			// Everything the vertex still connects to is contracted later, so its remaining arcs all lead upwards
+			contracted[vertex] = true;
+			upward[vertex] = remaining[vertex];
+			for (const auto& [from, arc] : needed) {
+				addArc(remaining[from], arc);
+				addArc(remaining[arc.to], Arc{ from, arc.length, arc.middle });
+			}
+			for (const auto& arc : remaining[vertex]) {
+				std::erase_if(remaining[arc.to], [vertex](const Arc& neighbourArc) { return neighbourArc.to == vertex; });
+				++contractedNeighbours[arc.to];
+			}
+			remaining[vertex].clear();
+		}
+	}
+
+	const ContractionHierarchy::Arc& ContractionHierarchy::FindArc(size_t lower, size_t higher) const noexcept {
+		return *std::ranges::find(upward[lower], higher, &Arc::to);
+	}
+
+	void ContractionHierarchy::Unpack(size_t from, size_t to, size_t middle, std::vector<Geometry::Vector2<float>>& vertices) const noexcept {
+		if (middle == Geometry::VisibilityGraph::NO_VERTEX) {
+			vertices.push_back(prepared->graph.vertices[to]);
+			return;
+		}
+
+		// The bypassed vertex was contracted before both ends, so the arcs to it are found among its upward arcs
+		Unpack(from, middle, FindArc(middle, from).middle, vertices);
+		Unpack(middle, to, FindArc(middle, to).middle, vertices);
+	}
+
+	Geometry::LineSequence ContractionHierarchy::FindPath(const Geometry::Vector2<float>& startingPosition,
+		const Geometry::Vector2<float>& goal) const NOEXCEPT_IF_NOT_DEBUG {
+
+		constexpr size_t NO_VERTEX = Geometry::VisibilityGraph::NO_VERTEX;
+
+		if (!Geometry::Intersect(*prepared, { startingPosition, goal })) {
+			return Geometry::LineSequence{ { startingPosition, goal } };
+		}
+
+		// Labels of the vertices reached by an upward search, keyed by vertex since only a few are ever reached
+		struct Label {
+			float distance;
+			size_t parent;
+			size_t middle;
+		};
+		using Labels = std::unordered_map<size_t, Label>;
+
+		auto search = [this](const Geometry::Vector2<float>& from) {
+			Labels labels;
+			MinQueue fringe;
+			for (const auto& edge : Geometry::VisibleVertices(*prepared, from)) {
+				auto found = labels.find(edge.to);
+				if (found == labels.end() || edge.length < found->second.distance) {
+					labels[edge.to] = { edge.length, NO_VERTEX, NO_VERTEX };
+					fringe.push({ edge.length, edge.to });
+				}
+			}
+			while (!fringe.empty()) {
+				const auto [distance, vertex] = fringe.top();
+				fringe.pop();
+				if (distance > labels[vertex].distance) {
+					continue;
+				}
+				for (const auto& arc : upward[vertex]) {
+					auto found = labels.find(arc.to);
+					if (found == labels.end() || distance + arc.length < found->second.distance) {
+						labels[arc.to] = { distance + arc.length, vertex, arc.middle };
+						fringe.push({ distance + arc.length, arc.to });
+					}
+				}
+			}
+			return labels;
+		};
+
+		const Labels forward = search(startingPosition);
+		const Labels backward = search(goal);
+
+		// The shortest path peaks at the vertex where the searches meet with the least combined distance
+		size_t meeting = NO_VERTEX;
+		float shortest = std::numeric_limits<float>::infinity();
+		for (const auto& [vertex, label] : forward) {
+			auto found = backward.find(vertex);
+			if (found != backward.end() && label.distance + found->second.distance < shortest) {
+				shortest = label.distance + found->second.distance;
+				meeting = vertex;
+			}
+		}
+		if (meeting == NO_VERTEX) {
+			return {};
+		}
+
+		// Walk down from the meeting vertex to where the forward search began, then unpack the arcs in path order
+		std::vector<size_t> ascent;
+		for (size_t vertex = meeting; vertex != NO_VERTEX; vertex = forward.at(vertex).parent) {
+			ascent.push_back(vertex);
+		}
+		std::ranges::reverse(ascent);
+
+		Geometry::LineSequence path{ { startingPosition, prepared->graph.vertices[ascent.front()] } };
+		for (auto it = std::next(ascent.begin()); it != ascent.end(); ++it) {
+			Unpack(*std::prev(it), *it, forward.at(*it).middle, path.vertices);
+		}
+		for (size_t vertex = meeting; backward.at(vertex).parent != NO_VERTEX; vertex = backward.at(vertex).parent) {
+			Unpack(vertex, backward.at(vertex).parent, backward.at(vertex).middle, path.vertices);
+		}
+		path.vertices.push_back(goal);
+		return path;
+	}
+}
\ No newline at end of file
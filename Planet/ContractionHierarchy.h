@@ -0,0 +1,45 @@
+#pragma once
+
+#include "PreparedWorld.h"
+
+namespace AStar {
+
+	// A contraction hierarchy over the visibility graph of a static world. Vertices are contracted one at a time, in order of
+	// how few shortcuts that requires, and every shortest path that went through a contracted vertex is kept as a shortcut.
+	// A query then only searches upwards in the hierarchy, from the vertices the start sees and from those the goal sees,
+	// which touches a tiny part of the graph. Building is expensive, so this is meant for worlds that rarely change.
+	class ContractionHierarchy {
+
+		struct Arc {
+			size_t to;
+			float length;
+
+			// The vertex a shortcut bypasses, or NO_VERTEX if the arc is an edge in the visibility graph
+			size_t middle;
+		};
+
+		// Shared with whoever else plans in the same world, rather than copied
+		std::shared_ptr<const Geometry::PreparedWorld> prepared;
+
+		// Arcs from each vertex to the neighbours contracted after it. The graph is undirected, so these serve both searches.
+		std::vector<std::vector<Arc>> upward;
+
+		// Returns the arc from the lower ranked of two vertices to the higher
+		[[nodiscard]] const Arc& FindArc(size_t lower, size_t higher) const noexcept;
+
+		// Appends the vertices of the arc between from and to, excluding from, expanding any shortcuts along the way
+		void Unpack(size_t from, size_t to, size_t middle, std::vector<Geometry::Vector2<float>>& vertices) const noexcept;
+
+	public:
+		ContractionHierarchy() = default;
+		explicit ContractionHierarchy(const std::vector<Geometry::Polygon>& world) NOEXCEPT_IF_NOT_DEBUG;
+		explicit ContractionHierarchy(std::shared_ptr<const Geometry::PreparedWorld> prepared) NOEXCEPT_IF_NOT_DEBUG;
+
+		// The version of the world this was built for
+		[[nodiscard]] size_t Version() const noexcept { return prepared->Version(); }
+
+		// Returns the shortest path from startingPosition to goal, or an empty sequence if there is none
+		[[nodiscard]] Geometry::LineSequence FindPath(const Geometry::Vector2<float>& startingPosition,
+			const Geometry::Vector2<float>& goal) const NOEXCEPT_IF_NOT_DEBUG;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "GoalTree.h"
+
+namespace AStar {
+
+	GoalTree::GoalTree(const std::vector<Geometry::Polygon>& world, const Geometry::Vector2<float>& goal) NOEXCEPT_IF_NOT_DEBUG :
+		GoalTree(Geometry::Prepare(Geometry::Publish(world)), goal) {}
+
+	GoalTree::GoalTree(std::shared_ptr<const Geometry::PreparedWorld> prepared, const Geometry::Vector2<float>& goal) NOEXCEPT_IF_NOT_DEBUG :
+		prepared(std::move(prepared)),
+		goal(goal),
+		tree(Geometry::ShortestPaths(this->prepared->graph, Geometry::VisibleVertices(*this->prepared, goal))) {}
+
+	size_t GoalTree::NextWaypoint(const Geometry::Vector2<float>& position) const NOEXCEPT_IF_NOT_DEBUG {
+		if (Geometry::InPolygon(prepared->Polygons(), position) != prepared->Polygons().end()) {
+			return Geometry::VisibilityGraph::NO_VERTEX;
+		}
+		if (!Geometry::Intersect(*prepared, { position, goal })) {
+			return GOAL;
+		}
+
+		// The best first step is to the visible vertex with the least total distance to the goal
+		size_t best = Geometry::VisibilityGraph::NO_VERTEX;
+		float shortest = std::numeric_limits<float>::infinity();
+		for (const auto& edge : Geometry::VisibleVertices(*prepared, position)) {
+			if (edge.length + tree.distances[edge.to] < shortest) {
+				shortest = edge.length + tree.distances[edge.to];
+				best = edge.to;
+			}
+		}
+		return best;
+	}
+
+	float GoalTree::DistanceThrough(const Geometry::Vector2<float>& position, size_t waypoint) const noexcept {
+		if (waypoint == Geometry::VisibilityGraph::NO_VERTEX) {
+			return std::numeric_limits<float>::infinity();
+		}
+		if (waypoint == GOAL) {
+			return (goal - position).Magnitude();
+		}
+		return (prepared->graph.vertices[waypoint] - position).Magnitude() + tree.distances[waypoint];
+	}
+
+	bool GoalTree::Sees(const Geometry::Vector2<float>& position, size_t waypoint) const NOEXCEPT_IF_NOT_DEBUG {
+		if (waypoint == Geometry::VisibilityGraph::NO_VERTEX) {
+			return false;
+		}
+		return !Geometry::Intersect(*prepared, { position, waypoint == GOAL ? goal : prepared->graph.vertices[waypoint] });
+	}
+
+	Geometry::LineSequence GoalTree::PathThrough(const Geometry::Vector2<float>& position, size_t waypoint) const noexcept {
+		if (waypoint == Geometry::VisibilityGraph::NO_VERTEX) {
+			return {};
+		}
+
+		// Follow the tree down to its root and on to the goal
+		Geometry::LineSequence path{ { position } };
+		for (size_t vertex = waypoint; vertex != Geometry::VisibilityGraph::NO_VERTEX && vertex != GOAL; vertex = tree.parents[vertex]) {
+			path.vertices.push_back(prepared->graph.vertices[vertex]);
+		}
+		path.vertices.push_back(goal);
+		return path;
+	}
+
+	Geometry::LineSequence GoalTree::FindPath(const Geometry::Vector2<float>& startingPosition) const NOEXCEPT_IF_NOT_DEBUG {
+		return PathThrough(startingPosition, NextWaypoint(startingPosition));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "PreparedWorld.h"
+
+namespace AStar {
+
+	// A shortest path tree rooted at a fixed goal, holding the distance to the goal from every vertex in the world and
+	// the vertex to continue to. Finding a path from anywhere then only takes finding the vertices the start can see and
+	// picking the one whose distance, added to the distance to it, is the least. No search is needed.
+	class GoalTree {
+
+		// Shared with whoever else plans in the same world, rather than copied
+		std::shared_ptr<const Geometry::PreparedWorld> prepared;
+		Geometry::Vector2<float> goal;
+
+		// Parents lead towards the goal, and the vertices which see the goal directly have none
+		Geometry::ShortestPathTree tree;
+
+	public:
+		// The waypoint of a position which sees the goal directly
+		static constexpr size_t GOAL = Geometry::VisibilityGraph::NO_VERTEX - 1;
+
+		GoalTree() = default;
+		GoalTree(const std::vector<Geometry::Polygon>& world, const Geometry::Vector2<float>& goal) NOEXCEPT_IF_NOT_DEBUG;
+		GoalTree(std::shared_ptr<const Geometry::PreparedWorld> prepared, const Geometry::Vector2<float>& goal) NOEXCEPT_IF_NOT_DEBUG;
+
+		[[nodiscard]] size_t Version() const noexcept { return prepared->Version(); }
+		[[nodiscard]] const Geometry::Vector2<float>& Goal() const noexcept { return goal; }
+		[[nodiscard]] const std::vector<Geometry::Polygon>& World() const noexcept { return prepared->Polygons(); }
+
+		// Returns the first vertex on the shortest path from position to the goal,
+		// GOAL if the goal is visible, or NO_VERTEX if there is no path
+		[[nodiscard]] size_t NextWaypoint(const Geometry::Vector2<float>& position) const NOEXCEPT_IF_NOT_DEBUG;
+
+		// Returns the length of the path from position through waypoint and on to the goal, whether or not waypoint is visible
+		[[nodiscard]] float DistanceThrough(const Geometry::Vector2<float>& position, size_t waypoint) const noexcept;
+
+		// Returns whether the waypoint can be walked to in a straight line from position
+		[[nodiscard]] bool Sees(const Geometry::Vector2<float>& position, size_t waypoint) const NOEXCEPT_IF_NOT_DEBUG;
+
+		// Returns the path from position through waypoint and on to the goal, or an empty sequence if waypoint is NO_VERTEX
+		[[nodiscard]] Geometry::LineSequence PathThrough(const Geometry::Vector2<float>& position, size_t waypoint) const noexcept;
+
+		// Returns the shortest path from startingPosition to the goal, or an empty sequence if there is none
+		[[nodiscard]] Geometry::LineSequence FindPath(const Geometry::Vector2<float>& startingPosition) const NOEXCEPT_IF_NOT_DEBUG;
+	};
+}
\ No newline at end of file
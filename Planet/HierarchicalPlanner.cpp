@@ -0,0 +1,513 @@
+#include "HierarchicalPlanner.h"
+#include "AStar.h"
+#include <algorithm>
+#include <queue>
+#include <cmath>
+
+namespace AStar {
+
+	namespace {
+		[[nodiscard]] std::pair<Geometry::Vector2<float>, Geometry::Vector2<float>> Bounds(const Geometry::Polygon& polygon) noexcept {
+			Geometry::Vector2<float> min = polygon.vertices.front(), max = polygon.vertices.front();
+			for (const auto& vertex : polygon.vertices) {
+				min = { std::min(min.x, vertex.x), std::min(min.y, vertex.y) };
+				max = { std::max(max.x, vertex.x), std::max(max.y, vertex.y) };
+			}
+			return { min, max };
+		}
+
+		// How close, as a fraction of the line, a line may pass a cluster corner for both clusters beside it to be walked
+		constexpr float CORNER_TOLERANCE = 1e-4f;
+
+		// How far from a polygon an entrance at the end of an uncovered stretch of side is placed, so that lines from it
+		// to either side are not taken to touch the polygon
+		constexpr float ENTRANCE_MARGIN = 10.0f * Constants::EPSILON;
+
+		// Returns whether vertex is an angular extremum of polygon as seen from position, as a shortest path only bends around those
+		[[nodiscard]] bool Tangent(const Geometry::Polygon& polygon, const Geometry::Vector2<float>& vertex, const Geometry::Vector2<float>& position) NOEXCEPT_IF_NOT_DEBUG {
+			const auto [leftMost, rightMost] = Geometry::GetAnglularExtrema(polygon, position);
+			return leftMost == vertex || rightMost == vertex;
+		}
+	}
+
+	HierarchicalPlanner::HierarchicalPlanner(Geometry::World world, float clusterSize) NOEXCEPT_IF_NOT_DEBUG :
+		world(std::move(world)),
+		clusterSize(clusterSize) {
+		features = Geometry::ComputeFeatures(this->world->polygons);
+		for (size_t polygon = 0; polygon < this->world->polygons.size(); ++polygon) {
+			Insert(polygon);
+		}
+	}
+
+	HierarchicalPlanner::ClusterKey HierarchicalPlanner::KeyOf(const Position& position) const noexcept {
+		return { static_cast<int>(std::floor(position.x / clusterSize)), static_cast<int>(std::floor(position.y / clusterSize)) };
+	}
+
+	// Every corner is computed the same way, so that the clusters sharing it agree on where it is to the last bit
+	HierarchicalPlanner::Position HierarchicalPlanner::Corner(int x, int y) const noexcept {
+		return { static_cast<float>(x) * clusterSize, static_cast<float>(y) * clusterSize };
+	}
+
+	void HierarchicalPlanner::Insert(size_t polygon) NOEXCEPT_IF_NOT_DEBUG {
+		const auto [min, max] = Bounds(world->polygons[polygon]);
+		const auto [polygonMinKey, polygonMaxKey] = std::make_pair(KeyOf(min), KeyOf(max));
+		for (int x = polygonMinKey.first; x <= polygonMaxKey.first; ++x) {
+			for (int y = polygonMinKey.second; y <= polygonMaxKey.second; ++y) {
+				clusters[{ x, y }].overlapping.push_back(polygon);
+			}
+		}
+		minKey = { std::min(minKey.first, polygonMinKey.first), std::min(minKey.second, polygonMinKey.second) };
+		maxKey = { std::max(maxKey.first, polygonMaxKey.first), std::max(maxKey.second, polygonMaxKey.second) };
+		MarkDirty(polygon);
+	}
+
+	// A polygon changes the local graphs of the clusters it overlaps, and the entrances on their sides, which the clusters
+	// around them share. Nothing further away tests against it.
+	void HierarchicalPlanner::MarkDirty(size_t index) noexcept {
+		const auto [min, max] = Bounds(world->polygons[index]);
+		const auto [polygonMinKey, polygonMaxKey] = std::make_pair(KeyOf(min), KeyOf(max));
+		for (int x = polygonMinKey.first - 1; x <= polygonMaxKey.first + 1; ++x) {
+			for (int y = polygonMinKey.second - 1; y <= polygonMaxKey.second + 1; ++y) {
+				if (auto found = clusters.find({ x, y }); found != clusters.end()) {
+					found->second.dirty = true;
+				}
+			}
+		}
+	}
+
+	void HierarchicalPlanner::AddPolygon(Geometry::World edited) NOEXCEPT_IF_NOT_DEBUG {
+		world = std::move(edited);
+		features.push_back(Geometry::ComputeFeatures(world->polygons.back()));
+		Insert(world->polygons.size() - 1);
+	}
+
+	void HierarchicalPlanner::RemovePolygon(Geometry::World edited, size_t index) noexcept {
+		MarkDirty(index);
+
+		// Polygons after the removed one move down a step, but that changes no geometry, so nothing else becomes dirty
+		for (auto& [key, cluster] : clusters) {
+			std::erase(cluster.overlapping, index);
+			for (auto& polygon : cluster.overlapping) {
+				if (polygon > index) {
+					--polygon;
+				}
+			}
+		}
+		features.erase(features.begin() + index);
+		world = std::move(edited);
+	}
+
+	void HierarchicalPlanner::AppendEntrances(int x, int y, bool horizontal, std::vector<Position>& entrances) const NOEXCEPT_IF_NOT_DEBUG {
+		const Position from = Corner(x, y);
+		const Position to = horizontal ? Corner(x + 1, y) : Corner(x, y + 1);
+
+		// Only the polygons overlapping the clusters on either side can cover the side
+		std::vector<size_t> candidates;
+		for (const ClusterKey& key : { ClusterKey{ x, y }, horizontal ? ClusterKey{ x, y - 1 } : ClusterKey{ x - 1, y } }) {
+			if (auto found = clusters.find(key); found != clusters.end()) {
+				candidates.insert(candidates.end(), found->second.overlapping.begin(), found->second.overlapping.end());
+			}
+		}
+		std::ranges::sort(candidates);
+		const auto [first, last] = std::ranges::unique(candidates);
+		candidates.erase(first, last);
+
+		// The stretch each convex polygon covers, as fractions of the side, is where the side lies inside all of its edges
+		std::vector<std::pair<float, float>> covered;
+		for (size_t polygon : candidates) {
+			const auto& vertices = world->polygons[polygon].vertices;
+			float area = 0.0f;
+			for (size_t vertex = 0; vertex < vertices.size(); ++vertex) {
+				area += Geometry::CrossZ(vertices[vertex], vertices[(vertex + 1) % vertices.size()]);
+			}
+			const float inward = area > 0.0f ? 1.0f : -1.0f;
+			float enter = 0.0f, leave = 1.0f;
+			for (size_t vertex = 0; vertex < vertices.size() && enter < leave; ++vertex) {
+				const Position edge = vertices[(vertex + 1) % vertices.size()] - vertices[vertex];
+				const float start = inward * Geometry::CrossZ(edge, from - vertices[vertex]);
+				const float rate = inward * Geometry::CrossZ(edge, to - from);
+				if (rate > 0.0f) {
+					enter = std::max(enter, -start / rate);
+				}
+				else if (rate < 0.0f) {
+					leave = std::min(leave, -start / rate);
+				}
+				else if (start < 0.0f) {
+					leave = enter;
+				}
+			}
+			if (enter < leave) {
+				covered.push_back({ enter, leave });
+			}
+		}
+		std::ranges::sort(covered);
+
+		// Every stretch left uncovered gets an entrance near either end, and more between them, so that a path crossing
+		// it is never led far out of its way. Stretches too narrow for that get one in the middle.
+		auto at = [&](float fraction) {
+			if (fraction <= 0.0f) {
+				return from;
+			}
+			if (fraction >= 1.0f) {
+				return to;
+			}
+			return horizontal ? Position{ from.x + fraction * clusterSize, from.y } : Position{ from.x, from.y + fraction * clusterSize };
+		};
+		const float margin = ENTRANCE_MARGIN / clusterSize;
+		auto place = [&](float begin, float end) {
+			if (end <= begin) {
+				return;
+			}
+			const float first = begin > 0.0f ? begin + margin : 0.0f;
+			const float last = end < 1.0f ? end - margin : 1.0f;
+			if (last < first) {
+				entrances.push_back(at(0.5f * (begin + end)));
+				return;
+			}
+			const size_t count = std::max<size_t>(static_cast<size_t>(std::ceil((last - first) * clusterSize / Constants::CLUSTER_ENTRANCE_SPACING)), 1);
+			for (size_t step = 0; step <= count; ++step) {
+				entrances.push_back(at(step == count ? last : first + (last - first) * static_cast<float>(step) / static_cast<float>(count)));
+			}
+		};
+		float uncovered = 0.0f;
+		for (const auto& [enter, leave] : covered) {
+			place(uncovered, enter);
+			uncovered = std::max(uncovered, leave);
+		}
+		place(uncovered, 1.0f);
+	}
+
+	void HierarchicalPlanner::AppendClustersOf(const Position& position, std::vector<ClusterKey>& keys) const noexcept {
+		// A coordinate on a line between clusters belongs to those on either side of it
+		auto columns = [this](float coordinate) {
+			const int line = static_cast<int>(std::lround(coordinate / clusterSize));
+			if (static_cast<float>(line) * clusterSize == coordinate) {
+				return std::make_pair(line - 1, line);
+			}
+			const int within = static_cast<int>(std::floor(coordinate / clusterSize));
+			return std::make_pair(within, within);
+		};
+		const auto [firstX, lastX] = columns(position.x);
+		const auto [firstY, lastY] = columns(position.y);
+		for (int x = firstX; x <= lastX; ++x) {
+			for (int y = firstY; y <= lastY; ++y) {
+				keys.push_back({ x, y });
+			}
+		}
+	}
+
+	bool HierarchicalPlanner::Blocked(const Cluster& cluster, const Position& a, const Position& b) const NOEXCEPT_IF_NOT_DEBUG {
+		return std::ranges::any_of(cluster.overlapping, [&](size_t polygon) {
+			return Geometry::Intersect(world->polygons[polygon], features[polygon], { a, b });
+		});
+	}
+
+	bool HierarchicalPlanner::Visible(const Position& a, const Position& b) const NOEXCEPT_IF_NOT_DEBUG {
+
+		// Walk the clusters the line passes through, gathering the polygons overlapping them
+		std::vector<size_t> candidates;
+		auto gather = [&](int x, int y) {
+			if (auto found = clusters.find({ x, y }); found != clusters.end()) {
+				candidates.insert(candidates.end(), found->second.overlapping.begin(), found->second.overlapping.end());
+			}
+		};
+		const Position direction = b - a;
+		auto [x, y] = KeyOf(a);
+		const auto [endX, endY] = KeyOf(b);
+		const int stepX = direction.x > 0.0f ? 1 : -1;
+		const int stepY = direction.y > 0.0f ? 1 : -1;
+		const float infinity = std::numeric_limits<float>::infinity();
+		float nextX = direction.x != 0.0f ? ((x + (stepX > 0 ? 1 : 0)) * clusterSize - a.x) / direction.x : infinity;
+		float nextY = direction.y != 0.0f ? ((y + (stepY > 0 ? 1 : 0)) * clusterSize - a.y) / direction.y : infinity;
+		const float deltaX = direction.x != 0.0f ? clusterSize / std::abs(direction.x) : infinity;
+		const float deltaY = direction.y != 0.0f ? clusterSize / std::abs(direction.y) : infinity;
+
+		// Every step is towards the end, so the walk stays within the clusters between the ends and takes exactly as many
+		// steps as there are columns and rows between them. Where the line passes close to a corner, rounding may step the
+		// wrong way around it, so both clusters beside the corner are gathered.
+		gather(x, y);
+		while (x != endX || y != endY) {
+			const bool alongX = y == endY || (x != endX && nextX < nextY);
+			if (x != endX && y != endY && std::abs(nextX - nextY) < CORNER_TOLERANCE) {
+				gather(alongX ? x : x + stepX, alongX ? y + stepY : y);
+			}
+			if (alongX) {
+				nextX += deltaX;
+				x += stepX;
+			}
+			else {
+				nextY += deltaY;
+				y += stepY;
+			}
+			gather(x, y);
+		}
+
+		std::ranges::sort(candidates);
+		const auto [first, last] = std::ranges::unique(candidates);
+		candidates.erase(first, last);
+		return std::ranges::none_of(candidates, [&](size_t polygon) {
+			return Geometry::Intersect(world->polygons[polygon], features[polygon], { a, b });
+		});
+	}
+
+	HierarchicalPlanner::Cluster& HierarchicalPlanner::Prepare(const ClusterKey& key) NOEXCEPT_IF_NOT_DEBUG {
+		Cluster& cluster = clusters[key];
+		if (cluster.dirty) {
+			Build(key, cluster);
+		}
+		return cluster;
+	}
+
+	void HierarchicalPlanner::Build(const ClusterKey& key, Cluster& cluster) NOEXCEPT_IF_NOT_DEBUG {
+		auto& local = cluster.local;
+		local = {};
+		auto add = [&local](const Position& position) {
+			const bool added = local.ids.try_emplace(position, local.vertices.size()).second;
+			if (added) {
+				local.vertices.push_back(position);
+			}
+			return added;
+		};
+
+		// The entrances on every side, the corners being shared by two of them
+		const auto [x, y] = key;
+		std::vector<Position> entrances;
+		AppendEntrances(x, y, true, entrances);
+		AppendEntrances(x, y + 1, true, entrances);
+		AppendEntrances(x, y, false, entrances);
+		AppendEntrances(x + 1, y, false, entrances);
+		for (const Position& entrance : entrances) {
+			add(entrance);
+		}
+		cluster.entranceCount = local.vertices.size();
+
+		// And the vertices within the cluster, with the polygon and place in it of each
+		std::vector<std::pair<size_t, size_t>> polygonOf(cluster.entranceCount);
+		for (size_t polygon : cluster.overlapping) {
+			const auto& vertices = world->polygons[polygon].vertices;
+			for (size_t vertex = 0; vertex < vertices.size(); ++vertex) {
+				if (KeyOf(vertices[vertex]) == key && add(vertices[vertex])) {
+					polygonOf.push_back({ polygon, vertex });
+				}
+			}
+		}
+
+		// Vertices of the same polygon are linked along its sides, which nothing can block. Everything else is linked by
+		// the lines it sees which are tangent to the polygons at either end, as a shortest path only bends around a vertex
+		// it passes. The line is within the cluster, so only the polygons overlapping it can block it.
+		local.edges.assign(local.vertices.size(), {});
+		for (size_t from = 0; from < local.vertices.size(); ++from) {
+			for (size_t to = from + 1; to < local.vertices.size(); ++to) {
+				const Position& a = local.vertices[from];
+				const Position& b = local.vertices[to];
+				const bool fromVertex = from >= cluster.entranceCount, toVertex = to >= cluster.entranceCount;
+				if (fromVertex && polygonOf[from].first == polygonOf[to].first) {
+					const size_t count = world->polygons[polygonOf[from].first].vertices.size();
+					const size_t first = polygonOf[from].second, second = polygonOf[to].second;
+					if ((first + 1) % count != second && (second + 1) % count != first) {
+						continue;
+					}
+				}
+				else if ((fromVertex && !Tangent(world->polygons[polygonOf[from].first], a, b))
+					|| (toVertex && !Tangent(world->polygons[polygonOf[to].first], b, a)) || Blocked(cluster, a, b)) {
+					continue;
+				}
+				const float length = (b - a).Magnitude();
+				local.edges[from].push_back({ to, length });
+				local.edges[to].push_back({ from, length });
+			}
+		}
+
+		cluster.entranceDistances.clear();
+		cluster.entranceDistances.reserve(cluster.entranceCount * cluster.entranceCount);
+		for (size_t entrance = 0; entrance < cluster.entranceCount; ++entrance) {
+			const auto tree = Geometry::ShortestPaths(local, { { entrance, 0.0f } });
+			cluster.entranceDistances.insert(cluster.entranceDistances.end(), tree.distances.begin(), tree.distances.begin() + cluster.entranceCount);
+		}
+		cluster.dirty = false;
+	}
+
+	Geometry::ShortestPathTree HierarchicalPlanner::PathsFrom(const Cluster& cluster, const Position& point) const NOEXCEPT_IF_NOT_DEBUG {
+		if (auto id = cluster.local.IdOf(point)) {
+			return Geometry::ShortestPaths(cluster.local, { { *id, 0.0f } });
+		}
+		std::vector<Geometry::VisibilityGraph::Edge> sources;
+		for (size_t vertex = 0; vertex < cluster.local.vertices.size(); ++vertex) {
+			const Position& position = cluster.local.vertices[vertex];
+			if (!Blocked(cluster, point, position)) {
+				sources.push_back({ vertex, (position - point).Magnitude() });
+			}
+		}
+		return Geometry::ShortestPaths(cluster.local, sources);
+	}
+
+	void HierarchicalPlanner::Trace(const Cluster& cluster, const Geometry::ShortestPathTree& tree, size_t vertex, std::vector<Position>& vertices) noexcept {
+		for (; vertex != Geometry::VisibilityGraph::NO_VERTEX; vertex = tree.parents[vertex]) {
+			vertices.push_back(cluster.local.vertices[vertex]);
+		}
+	}
+
+	// Going from the last vertex kept, the next is only kept if the one after it cannot be seen from there
+	void HierarchicalPlanner::PullStraight(std::vector<Position>& vertices) const NOEXCEPT_IF_NOT_DEBUG {
+		const auto [first, last] = std::ranges::unique(vertices);
+		vertices.erase(first, last);
+		size_t kept = 0;
+		for (size_t next = 1; next < vertices.size(); ++next) {
+			if (next + 1 == vertices.size() || !Visible(vertices[kept], vertices[next + 1])) {
+				vertices[++kept] = vertices[next];
+			}
+		}
+		vertices.resize(std::min(kept + 1, vertices.size()));
+	}
+
+	Geometry::LineSequence HierarchicalPlanner::FindPath(const Position& startingPosition, const Position& goal) NOEXCEPT_IF_NOT_DEBUG {
+		constexpr size_t NO_NODE = std::numeric_limits<size_t>::max();
+
+		if (Visible(startingPosition, goal)) {
+			return Geometry::LineSequence{ { startingPosition, goal } };
+		}
+
+		// The search keeps to the clusters around the world, the start and the goal, so that it ends if there is no path
+		const ClusterKey startKey = KeyOf(startingPosition);
+		const ClusterKey goalKey = KeyOf(goal);
+		const ClusterKey lower{ std::min({ minKey.first, startKey.first, goalKey.first }) - 1, std::min({ minKey.second, startKey.second, goalKey.second }) - 1 };
+		const ClusterKey upper{ std::max({ maxKey.first, startKey.first, goalKey.first }) + 1, std::max({ maxKey.second, startKey.second, goalKey.second }) + 1 };
+
+		// The distances within their clusters from the start and from the goal. Clusters live in nodes of the map, so
+		// references to them stay valid while others are added.
+		const Cluster& startCluster = Prepare(startKey);
+		const Cluster& goalCluster = Prepare(goalKey);
+		const Geometry::ShortestPathTree fromStart = PathsFrom(startCluster, startingPosition);
+		const Geometry::ShortestPathTree fromGoal = PathsFrom(goalCluster, goal);
+
+		// A* over the abstract graph, whose nodes are entrances, plus the goal. Each node remembers the cluster the step
+		// to it was taken within, which is searched again to refine it.
+		struct Node {
+			Position position;
+			float cost;
+			size_t parent;
+			ClusterKey within;
+			bool closed = false;
+		};
+		std::vector<Node> nodes;
+		std::unordered_map<Position, size_t, Geometry::Vector2Hash> indices;
+		using Entry = std::pair<float, size_t>;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> fringe;
+
+		// An entrance where the goal is only leads on to the goal, which is reached through the goal's cluster instead
+		auto relax = [&](const Position& position, float cost, size_t parent, const ClusterKey& within, bool entrance = true) {
+			if (std::isinf(cost) || (entrance && position == goal)) {
+				return;
+			}
+			auto [found, inserted] = indices.try_emplace(position, nodes.size());
+			if (inserted) {
+				nodes.push_back({ position, std::numeric_limits<float>::infinity(), NO_NODE, within });
+			}
+			Node& node = nodes[found->second];
+			if (!node.closed && cost < node.cost) {
+				node = { position, cost, parent, within };
+				fringe.push({ cost + (goal - position).Magnitude(), found->second });
+			}
+		};
+
+		for (size_t entrance = 0; entrance < startCluster.entranceCount; ++entrance) {
+			relax(startCluster.local.vertices[entrance], fromStart.distances[entrance], NO_NODE, startKey);
+		}
+		if (startKey == goalKey) {
+			float shortest = std::numeric_limits<float>::infinity();
+			for (size_t vertex = 0; vertex < startCluster.local.vertices.size(); ++vertex) {
+				shortest = std::min(shortest, fromStart.distances[vertex] + fromGoal.distances[vertex]);
+			}
+			relax(goal, shortest, NO_NODE, startKey, false);
+		}
+
+		size_t reached = NO_NODE;
+		std::vector<ClusterKey> keys;
+		while (!fringe.empty()) {
+			const size_t current = fringe.top().second;
+			fringe.pop();
+			if (nodes[current].closed) {
+				continue;
+			}
+			nodes[current].closed = true;
+			const Position position = nodes[current].position;
+			const float cost = nodes[current].cost;
+			if (position == goal) {
+				reached = current;
+				break;
+			}
+
+			// An entrance lies on the sides of two clusters, or four at a corner, and leads to the others of each
+			keys.clear();
+			AppendClustersOf(position, keys);
+			for (const ClusterKey& key : keys) {
+				if (key.first < lower.first || key.second < lower.second || key.first > upper.first || key.second > upper.second) {
+					continue;
+				}
+				const Cluster& cluster = Prepare(key);
+				const auto id = cluster.local.IdOf(position);
+				if (!id || *id >= cluster.entranceCount) {
+					continue;
+				}
+				const float* distances = &cluster.entranceDistances[*id * cluster.entranceCount];
+				for (size_t other = 0; other < cluster.entranceCount; ++other) {
+					if (other != *id) {
+						relax(cluster.local.vertices[other], cost + distances[other], current, key);
+					}
+				}
+				if (key == goalKey) {
+					relax(goal, cost + fromGoal.distances[*id], current, key, false);
+				}
+			}
+		}
+		if (reached == NO_NODE) {
+			return AStar::FindPath(world, startingPosition, goal);
+		}
+
+		// Refine the abstract path, searching again only the clusters it steps within
+		std::vector<size_t> route;
+		for (size_t node = reached; node != NO_NODE; node = nodes[node].parent) {
+			route.push_back(node);
+		}
+		std::ranges::reverse(route);
+
+		std::vector<Position> vertices{ startingPosition };
+		std::vector<Position> steps;
+		for (size_t node : route) {
+			const Node& step = nodes[node];
+			const Cluster& cluster = clusters.at(step.within);
+			const bool toGoal = step.position == goal;
+			steps.clear();
+			if (step.parent == NO_NODE && !toGoal) {
+				Trace(cluster, fromStart, *cluster.local.IdOf(step.position), steps);
+				vertices.insert(vertices.end(), steps.rbegin(), steps.rend());
+			}
+			else if (step.parent == NO_NODE) {
+				// Both ends in the same cluster, joined at the vertex their paths meet
+				size_t meeting = 0;
+				for (size_t vertex = 0; vertex < cluster.local.vertices.size(); ++vertex) {
+					if (fromStart.distances[vertex] + fromGoal.distances[vertex] < fromStart.distances[meeting] + fromGoal.distances[meeting]) {
+						meeting = vertex;
+					}
+				}
+				Trace(cluster, fromStart, meeting, steps);
+				vertices.insert(vertices.end(), steps.rbegin(), steps.rend());
+				steps.clear();
+				Trace(cluster, fromGoal, meeting, steps);
+				vertices.insert(vertices.end(), steps.begin() + 1, steps.end());
+			}
+			else if (toGoal) {
+				Trace(cluster, fromGoal, *cluster.local.IdOf(nodes[step.parent].position), steps);
+				vertices.insert(vertices.end(), steps.begin() + 1, steps.end());
+			}
+			else {
+				const size_t from = *cluster.local.IdOf(nodes[step.parent].position);
+				Trace(cluster, Geometry::ShortestPaths(cluster.local, { { from, 0.0f } }), *cluster.local.IdOf(step.position), steps);
+				vertices.insert(vertices.end(), steps.rbegin() + 1, steps.rend());
+			}
+		}
+		vertices.push_back(goal);
+		PullStraight(vertices);
+		return Geometry::LineSequence{ std::move(vertices) };
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "VisibilityGraph.h"
+#include "World.h"
+#include "Constants.h"
+
+namespace AStar {
+
+	// Hierarchical pathfinding for worlds too large to search flat. Space is divided into square clusters, and the sides
+	// between them are crossed at entrances, placed along the stretches of each side that no polygon covers. Within a
+	// cluster, its entrances and the vertices of its polygons make up a local visibility graph, from which the distance
+	// between every pair of its entrances is precomputed. A line between two points of a cluster stays within it, so only
+	// the polygons overlapping the cluster are tested against, however large the world is.
+	// A query links the start and the goal into their clusters, and searches the abstract graph of entrances, linked by
+	// those distances. The clusters on the route found are then searched again to refine it into actual vertices, and the
+	// refined path is pulled straight past the entrances it no longer needs to go through. Paths may still be a little
+	// longer than the shortest, as they only cross sides at entrances. Should the abstract search find nothing, the flat
+	// search is run instead.
+	// Adding or removing a polygon only invalidates the clusters it overlaps, whose graphs it changes, and those around
+	// them, which share their entrances. These are rebuilt the next time a search reaches them.
+	class HierarchicalPlanner {
+
+		using Position = Geometry::Vector2<float>;
+		using ClusterKey = std::pair<int, int>;
+
+		struct ClusterKeyHash {
+			[[nodiscard]] size_t operator()(const ClusterKey& key) const noexcept {
+				return std::hash<int>{}(key.first) ^ (std::hash<int>{}(key.second) << 1);
+			}
+		};
+
+		struct Cluster {
+
+			// Indices into the world of the polygons whose bounds overlap the cluster
+			std::vector<size_t> overlapping;
+
+			// Everything below is derived from the polygons overlapping the cluster and those around it, and is rebuilt when dirty
+			bool dirty = true;
+
+			// The local visibility graph, whose first entranceCount vertices are the entrances on the cluster's sides,
+			// followed by the vertices of polygons within it
+			Geometry::VisibilityGraph local;
+			size_t entranceCount = 0;
+			std::vector<float> entranceDistances; // From entrance i to entrance j at i * entranceCount + j
+		};
+
+		// The snapshot mirrored, which the flat search falls back on, and the features of its polygons
+		Geometry::World world;
+		std::vector<Geometry::PolygonFeatures> features;
+
+		float clusterSize = Constants::CLUSTER_SIZE;
+		std::unordered_map<ClusterKey, Cluster, ClusterKeyHash> clusters;
+
+		// The clusters overlapped by any polygon, which searches keep within, along with those around them
+		ClusterKey minKey{ std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+		ClusterKey maxKey{ std::numeric_limits<int>::min(), std::numeric_limits<int>::min() };
+
+		[[nodiscard]] ClusterKey KeyOf(const Position& position) const noexcept;
+		[[nodiscard]] Position Corner(int x, int y) const noexcept;
+		void Insert(size_t polygon) NOEXCEPT_IF_NOT_DEBUG;
+
+		// Marks the clusters whose graphs or entrances the polygon at index may change dirty
+		void MarkDirty(size_t index) noexcept;
+
+		// Appends the entrances of the side from Corner(x, y), along x if horizontal and along y otherwise
+		void AppendEntrances(int x, int y, bool horizontal, std::vector<Position>& entrances) const NOEXCEPT_IF_NOT_DEBUG;
+
+		// Appends the keys of the clusters whose sides position lies on, or of the one it lies in
+		void AppendClustersOf(const Position& position, std::vector<ClusterKey>& keys) const noexcept;
+
+		// Returns whether a line within cluster passes through any of its polygons
+		[[nodiscard]] bool Blocked(const Cluster& cluster, const Position& a, const Position& b) const NOEXCEPT_IF_NOT_DEBUG;
+
+		// Returns whether a line between a and b anywhere in the world passes no polygon, testing only the polygons in the
+		// clusters it crosses
+		[[nodiscard]] bool Visible(const Position& a, const Position& b) const NOEXCEPT_IF_NOT_DEBUG;
+
+		// Returns the cluster, rebuilding it first if it is dirty
+		Cluster& Prepare(const ClusterKey& key) NOEXCEPT_IF_NOT_DEBUG;
+		void Build(const ClusterKey& key, Cluster& cluster) NOEXCEPT_IF_NOT_DEBUG;
+
+		// Returns the shortest paths within the cluster from point, which must lie in it, to every vertex of its local graph
+		[[nodiscard]] Geometry::ShortestPathTree PathsFrom(const Cluster& cluster, const Position& point) const NOEXCEPT_IF_NOT_DEBUG;
+
+		// Appends the vertices of the local graph from vertex along the parents of tree, up to and including its source
+		static void Trace(const Cluster& cluster, const Geometry::ShortestPathTree& tree, size_t vertex, std::vector<Position>& vertices) noexcept;
+
+		// Removes the vertices of path that a straight line past them can skip
+		void PullStraight(std::vector<Position>& vertices) const NOEXCEPT_IF_NOT_DEBUG;
+
+	public:
+		HierarchicalPlanner() = default;
+		explicit HierarchicalPlanner(Geometry::World world, float clusterSize = Constants::CLUSTER_SIZE) NOEXCEPT_IF_NOT_DEBUG;
+
+		// Mirror edits to the world, given the snapshot after the edit. A polygon is added as the last of the world.
+		// Only the clusters around the polygon are invalidated.
+		void AddPolygon(Geometry::World edited) NOEXCEPT_IF_NOT_DEBUG;
+		void RemovePolygon(Geometry::World edited, size_t index) noexcept;
+
+		// Returns a path from startingPosition to goal, or an empty sequence if none was found
+		[[nodiscard]] Geometry::LineSequence FindPath(const Position& startingPosition, const Position& goal) NOEXCEPT_IF_NOT_DEBUG;
+	};
+}
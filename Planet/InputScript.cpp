@@ -0,0 +1,246 @@
+#include "InputScript.h"
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <cstdint>
+
+namespace SDLWrapper {
+
+	namespace {
+
+		// Names of the keys, in the order of Keyboard::KeyCode
+		constexpr std::array<std::string_view, static_cast<size_t>(Keyboard::KeyCode::KEYBOARD_SIZE)> KEY_NAMES = {
+			"NOT_SUPPORTED", "ESCAPE", "DELETE",
+			"1", "2", "3", "4", "5", "6", "7", "8", "9", "0",
+			"Q", "W", "E", "R", "T", "Y", "U", "I", "O", "P",
+			"A", "S", "D", "F", "G", "H", "J", "K", "L", "RETURN",
+			"Z", "X", "C", "V", "B", "N", "M",
+			"SPACE", "LEFT", "UP", "DOWN", "RIGHT"
+		};
+
+		std::optional<Keyboard::KeyCode> KeyNamed(std::string_view name) noexcept {
+			const auto found = std::ranges::find(KEY_NAMES, name);
+			if (found == KEY_NAMES.begin() || found == KEY_NAMES.end()) {
+				return std::nullopt;
+			}
+			return static_cast<Keyboard::KeyCode>(found - KEY_NAMES.begin());
+		}
+
+		// The binary form is this header, then every event as the steps since the previous event, its kind and what it holds.
+		// Numbers are written seven bits to a byte, with the high bit set on every byte but the last.
+		constexpr std::string_view BINARY_HEADER = "PLANETINPUT1";
+
+		void WriteNumber(std::ostream& out, uint64_t number) {
+			while (number >= 0x80) {
+				out.put(static_cast<char>((number & 0x7F) | 0x80));
+				number >>= 7;
+			}
+			out.put(static_cast<char>(number));
+		}
+
+		std::optional<uint64_t> ReadNumber(std::istream& in) {
+			uint64_t number = 0;
+			for (int shift = 0; shift < 64; shift += 7) {
+				const int byte = in.get();
+				if (byte == std::istream::traits_type::eof()) {
+					return std::nullopt;
+				}
+				number |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if (!(byte & 0x80)) {
+					return number;
+				}
+			}
+			return std::nullopt;
+		}
+
+		// Positions may be off screen, and so negative, which zigzagging keeps short
+		uint64_t Zigzag(int number) noexcept {
+			return (static_cast<uint64_t>(number) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(number) >> 63);
+		}
+
+		int Unzigzag(uint64_t number) noexcept {
+			return static_cast<int>(static_cast<int64_t>(number >> 1) ^ -static_cast<int64_t>(number & 1));
+		}
+
+		// Reads the event on line, or returns nothing if it is not understood
+		std::optional<InputScript::Event> ReadEvent(const std::string& line) {
+			using Kind = InputScript::Event::Kind;
+			std::istringstream words(line);
+			InputScript::Event event{};
+			std::string action, argument;
+			if (!(words >> event.step >> action)) {
+				return std::nullopt;
+			}
+			if (action == "press" || action == "release") {
+				event.kind = action == "press" ? Kind::PRESS : Kind::RELEASE;
+				std::optional<Keyboard::KeyCode> key;
+				if (!(words >> argument) || !(key = KeyNamed(argument))) {
+					return std::nullopt;
+				}
+				event.key = *key;
+			}
+			else if (action == "click") {
+				event.kind = Kind::CLICK;
+				if (!(words >> argument) || (argument != "left" && argument != "right")) {
+					return std::nullopt;
+				}
+				event.button = argument == "left" ? Mouse::Button::LEFT : Mouse::Button::RIGHT;
+			}
+			else if (action == "move") {
+				event.kind = Kind::MOVE;
+				if (!(words >> event.position.x >> event.position.y)) {
+					return std::nullopt;
+				}
+			}
+			else if (action == "end") {
+				event.kind = Kind::END;
+			}
+			else {
+				return std::nullopt;
+			}
+
+			// Nothing but a comment may follow
+			if (words >> argument && argument.front() != '#') {
+				return std::nullopt;
+			}
+			return event;
+		}
+	}
+
+	InputScript::InputScript(std::vector<Event> events) : events(std::move(events)) {
+		std::ranges::stable_sort(this->events, {}, &Event::step);
+	}
+
+	std::optional<InputScript> InputScript::Read(std::istream& in) NOEXCEPT_IF_NOT_DEBUG {
+		std::vector<Event> events;
+		std::string line;
+		for (size_t lineNumber = 1; std::getline(in, line); ++lineNumber) {
+			const size_t start = line.find_first_not_of(" \t\r");
+			if (start == std::string::npos || line[start] == '#') {
+				continue;
+			}
+			const std::optional<Event> event = ReadEvent(line);
+			if (!event) {
+				THROW_IF_DEBUG("Could not read input script: line " + std::to_string(lineNumber) + " is not understood");
+				return std::nullopt;
+			}
+			events.push_back(*event);
+		}
+		return InputScript(std::move(events));
+	}
+
+	bool InputScript::Save(std::ostream& out) const NOEXCEPT_IF_NOT_DEBUG {
+		out.write(BINARY_HEADER.data(), BINARY_HEADER.size());
+		size_t previousStep = 0;
+		for (const Event& event : events) {
+			WriteNumber(out, event.step - previousStep);
+			previousStep = event.step;
+			out.put(static_cast<char>(event.kind));
+			switch (event.kind) {
+			case Event::Kind::PRESS:
+			case Event::Kind::RELEASE:
+				out.put(static_cast<char>(event.key));
+				break;
+			case Event::Kind::CLICK:
+				out.put(static_cast<char>(event.button));
+				break;
+			case Event::Kind::MOVE:
+				WriteNumber(out, Zigzag(event.position.x));
+				WriteNumber(out, Zigzag(event.position.y));
+				break;
+			default:
+				break;
+			}
+		}
+		if (!out) {
+			THROW_IF_DEBUG("Could not save input script");
+			return false;
+		}
+		return true;
+	}
+
+	std::optional<InputScript> InputScript::Load(std::istream& in) NOEXCEPT_IF_NOT_DEBUG {
+		std::string header(BINARY_HEADER.size(), '\0');
+		in.read(header.data(), header.size());
+		if (header != BINARY_HEADER) {
+			in.clear();
+			in.seekg(0);
+			return Read(in);
+		}
+
+		std::vector<Event> events;
+		size_t step = 0;
+		while (in.peek() != std::istream::traits_type::eof()) {
+			Event event{};
+			const std::optional<uint64_t> delta = ReadNumber(in);
+			const int kind = in.get();
+			if (!delta || kind < 0 || kind > static_cast<int>(Event::Kind::END)) {
+				THROW_IF_DEBUG("Could not load input script: event " + std::to_string(events.size()) + " is corrupt");
+				return std::nullopt;
+			}
+			step += static_cast<size_t>(*delta);
+			event.step = step;
+			event.kind = static_cast<Event::Kind>(kind);
+
+			bool valid = true;
+			switch (event.kind) {
+			case Event::Kind::PRESS:
+			case Event::Kind::RELEASE: {
+				const int key = in.get();
+				valid = key > 0 && key < static_cast<int>(Keyboard::KeyCode::KEYBOARD_SIZE);
+				event.key = static_cast<Keyboard::KeyCode>(key);
+				break;
+			}
+			case Event::Kind::CLICK: {
+				const int button = in.get();
+				valid = button == static_cast<int>(Mouse::Button::LEFT) || button == static_cast<int>(Mouse::Button::RIGHT);
+				event.button = static_cast<Mouse::Button>(button);
+				break;
+			}
+			case Event::Kind::MOVE: {
+				const std::optional<uint64_t> x = ReadNumber(in), y = ReadNumber(in);
+				valid = x && y;
+				if (valid) {
+					event.position = { Unzigzag(*x), Unzigzag(*y) };
+				}
+				break;
+			}
+			default:
+				break;
+			}
+			if (!valid) {
+				THROW_IF_DEBUG("Could not load input script: event " + std::to_string(events.size()) + " is corrupt");
+				return std::nullopt;
+			}
+			events.push_back(event);
+		}
+		return InputScript(std::move(events));
+	}
+
+	void InputScript::Apply(size_t step, Keyboard& keyboard, Mouse& mouse) const noexcept {
+		for (const Event& event : std::ranges::equal_range(events, step, {}, &Event::step)) {
+			switch (event.kind) {
+			case Event::Kind::PRESS:
+				keyboard.Press(event.key);
+				break;
+			case Event::Kind::RELEASE:
+				keyboard.Release(event.key);
+				break;
+			case Event::Kind::CLICK:
+				mouse.Click(event.button);
+				break;
+			case Event::Kind::MOVE:
+				mouse.MoveTo(event.position);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	size_t InputScript::Length() const noexcept {
+		return events.empty() ? 0 : events.back().step + 1;
+	}
+}
\ No newline at end of file
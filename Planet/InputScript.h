@@ -0,0 +1,56 @@
+#pragma once
+
+#include "SDLWrapper.h"
+#include <vector>
+#include <optional>
+#include <istream>
+#include <ostream>
+#include <cstddef>
+
+namespace SDLWrapper {
+
+	// Input to feed the keyboard and mouse at given steps of a simulation, instead of taking it from the user, so that a
+	// session can be run again without a window, and as fast as the application steps.
+	//
+	// As text, each line is a step followed by what happens at it, where blank lines and lines starting with # are skipped:
+	//
+	//     0 move 360 240   moves the mouse to pixel 360, 240
+	//     0 click left     clicks the left (or right) mouse button
+	//     5 press P        presses a key, named as in Keyboard::KeyCode, or its digit for the number keys
+	//     9 release P      releases it again
+	//   600 end            does nothing, but lasts until step 600
+	class InputScript {
+	public:
+		struct Event {
+			enum class Kind { PRESS, RELEASE, CLICK, MOVE, END } kind;
+			size_t step = 0;
+			Keyboard::KeyCode key = Keyboard::KeyCode::NOT_SUPPORTED;
+			Mouse::Button button = Mouse::Button::LEFT;
+			Geometry::Vector2<int> position{};
+		};
+
+	private:
+		std::vector<Event> events; // Ordered by step, and otherwise as they happen
+
+	public:
+		InputScript() = default;
+		explicit InputScript(std::vector<Event> events);
+
+		// Reads a script in the text form above, or returns nothing if any line is not understood
+		[[nodiscard]] static std::optional<InputScript> Read(std::istream& in) NOEXCEPT_IF_NOT_DEBUG;
+
+		// Writes the script in a compact binary form, a few bytes per event, for recordings of long sessions. Open in binary mode.
+		bool Save(std::ostream& out) const NOEXCEPT_IF_NOT_DEBUG;
+
+		// Reads a script in either form, telling them apart by the header the binary form starts with. Open in binary mode.
+		[[nodiscard]] static std::optional<InputScript> Load(std::istream& in) NOEXCEPT_IF_NOT_DEBUG;
+
+		// Feeds keyboard and mouse the events at step, in order
+		void Apply(size_t step, Keyboard& keyboard, Mouse& mouse) const noexcept;
+
+		// How many steps the script lasts, up to and including its last event
+		[[nodiscard]] size_t Length() const noexcept;
+
+		[[nodiscard]] const std::vector<Event>& Events() const noexcept { return events; }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "Landmarks.h"
+#include <algorithm>
+#include <cmath>
+
+namespace AStar {
+
+	Landmarks::Landmarks(const Geometry::VisibilityGraph& graph, size_t count) noexcept :
+		count(std::min(count, graph.vertices.size())),
+		distances(graph.vertices.size() * this->count),
+		goalDistances(this->count) {
+
+		if (this->count == 0) {
+			return;
+		}
+
+		// The distance from each vertex to its closest landmark so far. Unreachable vertices are infinitely far away,
+		// so a landmark ends up in every disconnected part of the graph before any part gets a second one.
+		std::vector<float> closest(graph.vertices.size(), std::numeric_limits<float>::infinity());
+
+		// Start furthest away from an arbitrary vertex, which is likely to be on the outskirts of the world
+		const auto arbitrary = Geometry::ShortestPaths(graph, { { 0, 0.0f } });
+		size_t landmark = std::ranges::max_element(arbitrary.distances, [](float lhs, float rhs) {
+			return (std::isinf(lhs) ? -1.0f : lhs) < (std::isinf(rhs) ? -1.0f : rhs);
+		}) - arbitrary.distances.begin();
+
+		for (size_t i = 0; i < this->count; ++i) {
+			const auto tree = Geometry::ShortestPaths(graph, { { landmark, 0.0f } });
+			for (size_t vertex = 0; vertex < graph.vertices.size(); ++vertex) {
+				distances[vertex * this->count + i] = tree.distances[vertex];
+				closest[vertex] = std::min(closest[vertex], tree.distances[vertex]);
+			}
+			landmark = std::ranges::max_element(closest) - closest.begin();
+		}
+	}
+
+	void Landmarks::SetGoal(const std::vector<Geometry::Polygon>& world, const Geometry::VisibilityGraph& graph,
+		const Geometry::Vector2<float>& goal) NOEXCEPT_IF_NOT_DEBUG {
+
+		// Start from the vertices the goal sees as angular extrema, or from the goal itself if it is a vertex, which are
+		// nearly always closest already
+		if (auto id = graph.IdOf(goal)) {
+			std::copy_n(distances.begin() + *id * count, count, goalDistances.begin());
+		}
+		else {
+			std::ranges::fill(goalDistances, std::numeric_limits<float>::infinity());
+			for (const auto& edge : Geometry::VisibleVertices(world, graph, goal)) {
+				for (size_t i = 0; i < count; ++i) {
+					goalDistances[i] = std::min(goalDistances[i], distances[edge.to * count + i] + edge.length);
+				}
+			}
+		}
+
+		// Then go through every other vertex, though only testing whether it sees the goal if it would be closer to some landmark
+		for (size_t vertex = 0; vertex < graph.vertices.size(); ++vertex) {
+			const float length = (graph.vertices[vertex] - goal).Magnitude();
+			bool closer = false;
+			for (size_t i = 0; i < count && !closer; ++i) {
+				closer = distances[vertex * count + i] + length < goalDistances[i];
+			}
+			if (!closer || Geometry::Intersect(world, { graph.vertices[vertex], goal })) {
+				continue;
+			}
+			for (size_t i = 0; i < count; ++i) {
+				goalDistances[i] = std::min(goalDistances[i], distances[vertex * count + i] + length);
+			}
+		}
+	}
+
+	float Landmarks::Heuristic(size_t vertex) const noexcept {
+		float bound = 0.0f;
+		for (size_t i = 0; i < count; ++i) {
+			const float toVertex = distances[vertex * count + i];
+
+			// A landmark which cannot reach both the vertex and the goal bounds nothing
+			if (std::isinf(toVertex) || std::isinf(goalDistances[i])) {
+				continue;
+			}
+			bound = std::max(bound, std::abs(goalDistances[i] - toVertex));
+		}
+		return bound;
+	}
+}
\ No newline at end of file
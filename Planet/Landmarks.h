@@ -0,0 +1,38 @@
+#pragma once
+
+#include "VisibilityGraph.h"
+
+namespace AStar {
+
+	// The ALT heuristic (A*, landmarks and triangle inequality). Shortest distances from a few landmark vertices
+	// to every vertex are precomputed, after which the triangle inequality gives |d(L, goal) - d(L, n)| <= d(n, goal)
+	// for every landmark L. This is far better informed than the euclidean distance in worlds that force long detours.
+	// The bound only holds for the paths the solver finds if every line it follows is an edge of the graph, so the
+	// graph must be built with VisibilityGraph::Lines::EXTREMUM.
+	class Landmarks {
+
+		size_t count = 0;
+
+		// Distance from each landmark to each vertex, stored per vertex so that one lookup reads a single cache line
+		std::vector<float> distances;
+
+		// Distance from each landmark to the current goal
+		std::vector<float> goalDistances;
+
+	public:
+		Landmarks() = default;
+
+		// Picks count landmarks by farthest point selection, such that each landmark is the vertex furthest from those already picked
+		Landmarks(const Geometry::VisibilityGraph& graph, size_t count) noexcept;
+
+		[[nodiscard]] size_t Count() const noexcept { return count; }
+
+		// Computes the distances from every landmark to goal, which need not be a vertex. The solver steps to the goal from
+		// any vertex that sees it, so the distances go through whichever of those is closest to each landmark.
+		void SetGoal(const std::vector<Geometry::Polygon>& world, const Geometry::VisibilityGraph& graph,
+			const Geometry::Vector2<float>& goal) NOEXCEPT_IF_NOT_DEBUG;
+
+		// Returns a lower bound on the distance from vertex to the goal
+		[[nodiscard]] float Heuristic(size_t vertex) const noexcept;
+	};
+}
\ No newline at end of file
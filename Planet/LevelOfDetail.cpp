@@ -0,0 +1,61 @@
+#include "LevelOfDetail.h"
+#include "Constants.h"
+#include <algorithm>
+#include <ranges>
+#include <cmath>
+
+namespace Geometry {
+
+	namespace {
+		// The area of the triangle a vertex makes with its neighbours, which is what removing the vertex takes off the polygon
+		float RemovedArea(const std::vector<Vector2<float>>& vertices, size_t vertex) noexcept {
+			const auto& previous = vertices[(vertex + vertices.size() - 1) % vertices.size()];
+			const auto& next = vertices[(vertex + 1) % vertices.size()];
+			return std::abs(CrossZ(vertices[vertex] - previous, next - vertices[vertex]));
+		}
+	}
+
+	DetailLevels BuildDetailLevels(const Polygon& polygon) {
+		DetailLevels detail;
+		auto [minX, maxX] = std::ranges::minmax(polygon.vertices | std::views::transform(&Vector2<float>::x));
+		auto [minY, maxY] = std::ranges::minmax(polygon.vertices | std::views::transform(&Vector2<float>::y));
+		detail.min = { minX, minY };
+		detail.max = { maxX, maxY };
+
+		// Remove the vertices that change the shape the least, until half are gone
+		Polygon level = polygon;
+		while (level.vertices.size() > 3) {
+			const size_t target = std::max<size_t>(level.vertices.size() / 2, 3);
+			while (level.vertices.size() > target) {
+				size_t least = 0;
+				for (size_t vertex = 1; vertex < level.vertices.size(); ++vertex) {
+					if (RemovedArea(level.vertices, vertex) < RemovedArea(level.vertices, least)) {
+						least = vertex;
+					}
+				}
+				level.vertices.erase(level.vertices.begin() + least);
+			}
+			detail.levels.push_back(level);
+		}
+		return detail;
+	}
+
+	Detail ChooseDetail(const Polygon& polygon, const DetailLevels& detail, float pixelsPerUnit) noexcept {
+		const Vector2<float> extent = detail.max - detail.min;
+		const float pixels = std::max(extent.x, extent.y) * pixelsPerUnit;
+		if (pixels < Constants::POINT_IMPOSTOR_PIXELS) {
+			return { Detail::Kind::POINT };
+		}
+		if (pixels < Constants::QUAD_IMPOSTOR_PIXELS) {
+			return { Detail::Kind::QUAD };
+		}
+
+		// The first level with few enough vertices to be told apart at this size, or the polygon itself if it already has
+		const size_t vertexBudget = std::max<size_t>(static_cast<size_t>(pixels / Constants::PIXELS_PER_DETAIL_VERTEX), 3);
+		if (polygon.vertices.size() <= vertexBudget) {
+			return { Detail::Kind::POLYGON, &polygon };
+		}
+		auto level = std::ranges::find_if(detail.levels, [vertexBudget](const Polygon& level) { return level.vertices.size() <= vertexBudget; });
+		return { Detail::Kind::POLYGON, level != detail.levels.end() ? &*level : &detail.levels.back() };
+	}
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Shapes.h"
+#include <vector>
+
+namespace Geometry {
+
+	// Cheaper stand-ins for a polygon, for drawing it when it is too small on screen for all of its vertices to show
+	struct DetailLevels {
+
+		// The bounding box, which is drawn instead once the polygon is only a few pixels across
+		Vector2<float> min, max;
+
+		// The polygon with about half as many vertices as the level before, down to a triangle. Removing vertices from a
+		// convex polygon leaves it convex, so every level is its own convex hull.
+		std::vector<Polygon> levels;
+	};
+
+	[[nodiscard]] DetailLevels BuildDetailLevels(const Polygon& polygon);
+
+	// What to draw for a polygon: the polygon or one of its levels, or else its bounding box or a single pixel
+	struct Detail {
+		enum class Kind { POLYGON, QUAD, POINT } kind;
+		const Polygon* polygon = nullptr;
+	};
+
+	// Picks the detail for a polygon drawn at pixelsPerUnit pixels per world space unit
+	[[nodiscard]] Detail ChooseDetail(const Polygon& polygon, const DetailLevels& detail, float pixelsPerUnit) noexcept;
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <atomic>
+#include <optional>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <limits>
+
+namespace Threading {
+
+	// Counts of the operations on a concurrent queue, and of how often threads got in each other's way as failed attempts to lock
+	struct QueueStatistics {
+		size_t pushes = 0;
+		size_t pops = 0;
+		size_t failedLocks = 0;
+		size_t peakSize = 0; // The most items the queue held at once
+	};
+
+	// A relaxed concurrent priority queue. Items are spread over many heaps with a lock each, and a pop takes the better of
+	// the tops of two random heaps. This no longer returns the very lowest priority item, but one close to it, which in return
+	// lets threads work on different heaps instead of serialising on one lock.
+	// The heaps are made once, for the most threads that may share the queue, and Reset picks how many of them are used.
+	template <typename T>
+	class MultiQueue {
+
+		struct Entry {
+			float priority;
+			T value;
+		};
+
+		// std heaps keep the greatest on top, and we want the lowest priority there
+		static bool Later(const Entry& lhs, const Entry& rhs) noexcept {
+			return lhs.priority > rhs.priority;
+		}
+
+		struct Heap {
+			std::mutex mutex;
+			std::optional<std::pmr::vector<Entry>> entries; // Made by Reset, on the resource it is given
+
+			// The priority of the top entry, readable without the lock so that pops can choose a heap before locking it
+			std::atomic<float> top{ std::numeric_limits<float>::infinity() };
+
+			void UpdateTop() noexcept {
+				top.store(!entries || entries->empty() ? std::numeric_limits<float>::infinity() : entries->front().priority, std::memory_order_relaxed);
+			}
+		};
+
+		std::vector<std::unique_ptr<Heap>> heaps;
+		size_t activeHeaps = 1; // Only the first this many heaps are pushed to and popped from
+		std::atomic<size_t> size{0};
+
+		std::atomic<size_t> pushes{0}, pops{0}, failedLocks{0}, peakSize{0};
+
+		[[nodiscard]] size_t RandomHeap() const noexcept {
+			thread_local std::minstd_rand random(static_cast<unsigned>(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+			return random() % activeHeaps;
+		}
+
+	public:
+		explicit MultiQueue(size_t heapCount) {
+			heaps.reserve(std::max<size_t>(heapCount, 1));
+			for (size_t heap = 0; heap < std::max<size_t>(heapCount, 1); ++heap) {
+				heaps.push_back(std::make_unique<Heap>());
+			}
+		}
+
+		[[nodiscard]] size_t HeapCount() const noexcept { return activeHeaps; }
+		[[nodiscard]] bool Empty() const noexcept { return size.load() == 0; }
+
+		// The lowest priority among the tops of the heaps, or infinity if they are all empty. Read without locking, so
+		// pushes and pops under way at the same time may or may not be seen.
+		[[nodiscard]] float LowestPriority() const noexcept {
+			float lowest = std::numeric_limits<float>::infinity();
+			for (size_t heap = 0; heap < activeHeaps; ++heap) {
+				lowest = std::min(lowest, heaps[heap]->top.load(std::memory_order_relaxed));
+			}
+			return lowest;
+		}
+
+		void Push(T value, float priority) {
+			pushes.fetch_add(1, std::memory_order_relaxed);
+			for (;;) {
+				Heap& heap = *heaps[RandomHeap()];
+				std::unique_lock lock(heap.mutex, std::try_to_lock);
+				if (!lock) {
+					failedLocks.fetch_add(1, std::memory_order_relaxed);
+					continue;
+				}
+				heap.entries->push_back({ priority, std::move(value) });
+				std::push_heap(heap.entries->begin(), heap.entries->end(), Later);
+				heap.UpdateTop();
+				const size_t held = size.fetch_add(1) + 1;
+				for (size_t peak = peakSize.load(std::memory_order_relaxed); held > peak && !peakSize.compare_exchange_weak(peak, held, std::memory_order_relaxed);) {}
+				return;
+			}
+		}
+
+		// Takes an item with a low priority, or returns nothing once every heap is empty
+		std::optional<T> Pop() {
+			while (size.load() > 0) {
+				const size_t first = RandomHeap(), second = RandomHeap();
+				Heap& heap = heaps[first]->top.load(std::memory_order_relaxed) <= heaps[second]->top.load(std::memory_order_relaxed)
+					? *heaps[first] : *heaps[second];
+				std::unique_lock lock(heap.mutex, std::try_to_lock);
+				if (!lock) {
+					failedLocks.fetch_add(1, std::memory_order_relaxed);
+					continue;
+				}
+				if (heap.entries->empty()) {
+					continue;
+				}
+				std::pop_heap(heap.entries->begin(), heap.entries->end(), Later);
+				T value = std::move(heap.entries->back().value);
+				heap.entries->pop_back();
+				heap.UpdateTop();
+				size.fetch_sub(1);
+				pops.fetch_add(1, std::memory_order_relaxed);
+				return value;
+			}
+			return {};
+		}
+
+		// Empties the queue and gives all of its entries' memory back. The queue may not be used again until it is Reset.
+		// Neither may race with pushes or pops.
+		void Release() noexcept {
+			for (auto& heap : heaps) {
+				heap->entries.reset();
+				heap->UpdateTop();
+			}
+			size = 0;
+		}
+
+		// Empties the queue and resets its statistics. From then on only the first heapCount heaps are used, but at least
+		// one and at most all of them, and their entries are allocated from resource.
+		void Reset(size_t heapCount, std::pmr::memory_resource* resource) {
+			for (auto& heap : heaps) {
+				heap->entries.emplace(resource);
+				heap->UpdateTop();
+			}
+			activeHeaps = std::clamp<size_t>(heapCount, 1, heaps.size());
+			size = 0;
+			pushes = pops = failedLocks = peakSize = 0;
+		}
+
+		[[nodiscard]] QueueStatistics GetStatistics() const noexcept {
+			return { pushes.load(), pops.load(), failedLocks.load(), peakSize.load() };
+		}
+	};
+}
\ No newline at end of file
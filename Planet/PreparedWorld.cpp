@@ -0,0 +1,34 @@
+#include "PreparedWorld.h"
+
+namespace Geometry {
+
+	std::shared_ptr<const PreparedWorld> Prepare(World world) NOEXCEPT_IF_NOT_DEBUG {
+		auto prepared = std::make_shared<PreparedWorld>();
+		prepared->world = std::move(world);
+		prepared->features = ComputeFeatures(prepared->Polygons());
+		prepared->graph = VisibilityGraph(prepared->Polygons(), prepared->features);
+		return prepared;
+	}
+
+	bool Intersect(const PreparedWorld& world, const Line& line) NOEXCEPT_IF_NOT_DEBUG {
+		return Intersect(world.Polygons(), world.features, line);
+	}
+
+	std::vector<VisibilityGraph::Edge> VisibleVertices(const PreparedWorld& world, const Vector2<float>& point) NOEXCEPT_IF_NOT_DEBUG {
+		if (auto id = world.graph.IdOf(point)) {
+			return world.graph.edges[*id];
+		}
+
+		std::vector<VisibilityGraph::Edge> visible;
+		for (const auto& polygon : world.Polygons()) {
+			const auto& [leftMost, rightMost] = GetAnglularExtrema(polygon, point);
+			if (!Intersect(world, { point, leftMost })) {
+				visible.push_back({ world.graph.ids.at(leftMost), (leftMost - point).Magnitude() });
+			}
+			if (!Intersect(world, { point, rightMost })) {
+				visible.push_back({ world.graph.ids.at(rightMost), (rightMost - point).Magnitude() });
+			}
+		}
+		return visible;
+	}
+}
\ No newline at end of file
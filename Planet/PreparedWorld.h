@@ -0,0 +1,26 @@
+#pragma once
+
+#include "VisibilityGraph.h"
+#include "World.h"
+
+namespace Geometry {
+
+	// Everything the planners derive from a world, computed once and never modified afterwards, so that it can be shared
+	// between threads and planners without copying or locking
+	struct PreparedWorld {
+		World world;
+		std::vector<PolygonFeatures> features;
+		VisibilityGraph graph;
+
+		[[nodiscard]] const std::vector<Polygon>& Polygons() const noexcept { return world->polygons; }
+		[[nodiscard]] size_t Version() const noexcept { return world->version; }
+	};
+
+	// Prepares world in stages that each run in parallel over the shared thread pool:
+	// the features of every polygon, then the visibility edges of every vertex
+	[[nodiscard]] std::shared_ptr<const PreparedWorld> Prepare(World world) NOEXCEPT_IF_NOT_DEBUG;
+
+	// As Intersect(world, line) and VisibleVertices(world, graph, point), using the prepared features
+	[[nodiscard]] bool Intersect(const PreparedWorld& world, const Line& line) NOEXCEPT_IF_NOT_DEBUG;
+	[[nodiscard]] std::vector<VisibilityGraph::Edge> VisibleVertices(const PreparedWorld& world, const Vector2<float>& point) NOEXCEPT_IF_NOT_DEBUG;
+}
\ No newline at end of file
@@ -6,8 +6,8 @@
 namespace SDLWrapper {
 	int Initialize() NOEXCEPT_IF_NOT_DEBUG {
 
-		// Init everything, return on error, print and throw if _DEBUG is defined
-		if (int returnCode = SDL_Init(SDL_INIT_EVERYTHING)) {
+		// Init what the window needs, return on error, print and throw if _DEBUG is defined
+		if (int returnCode = SDL_Init(SDL_INIT_VIDEO)) {
 			THROW_SDL_ERROR_IF_DEBUG("Could not initialize SDL");
 			return returnCode;
 		}
@@ -27,37 +27,30 @@ namespace SDLWrapper {
 
 			// Notify input observers.
 
+			case SDL_MOUSEMOTION:
+				mouse.MoveTo({ e.motion.x, e.motion.y });
+				break;
 			case SDL_MOUSEBUTTONDOWN:
+				mouse.MoveTo({ e.button.x, e.button.y });
 				if (e.button.button == 1) {
-					std::for_each(std::execution::unseq, mouse.observers.begin(), mouse.observers.end(), [](auto& observer) {
-						observer->OnMouseClicked(Mouse::Button::LEFT);
-					});
+					mouse.Click(Mouse::Button::LEFT);
 				}
 				else if (e.button.button == 3) {
-					std::for_each(std::execution::unseq, mouse.observers.begin(), mouse.observers.end(), [](auto& observer) {
-						observer->OnMouseClicked(Mouse::Button::RIGHT);
-					});
+					mouse.Click(Mouse::Button::RIGHT);
 				}
 				break;
-			case SDL_KEYDOWN: {
-				Keyboard::KeyCode key = Keyboard::TranslateKeyCode(e.key.keysym.scancode);
-				if (key == Keyboard::KeyCode::NOT_SUPPORTED || keyboard.keyMap.test(static_cast<size_t>(key))) {
-					break;
-				}
-				keyboard.keyMap.set(static_cast<size_t>(key));
-				std::for_each(std::execution::unseq, keyboard.observers.begin(), keyboard.observers.end(), [key](auto& observer) {
-					observer->OnKeyPressed(key);
-				});
+			case SDL_KEYDOWN:
+				keyboard.Press(Keyboard::TranslateKeyCode(e.key.keysym.scancode));
 				break;
-			}
-			case SDL_KEYUP: {
-				Keyboard::KeyCode key = Keyboard::TranslateKeyCode(e.key.keysym.scancode);
-				if (key == Keyboard::KeyCode::NOT_SUPPORTED) {
-					break;
-				}
-				keyboard.keyMap.reset(static_cast<size_t>(key));
+			case SDL_KEYUP:
+				keyboard.Release(Keyboard::TranslateKeyCode(e.key.keysym.scancode));
+				break;
+
+			// Textures rendered to are lost with the device, and the static layer with them
+			case SDL_RENDER_TARGETS_RESET:
+			case SDL_RENDER_DEVICE_RESET:
+				screen.renderer.DropStaticLayer();
 				break;
-			}
 			default:
 				break;
 			}
@@ -65,10 +58,60 @@ namespace SDLWrapper {
 		return true;
 	}
 
+	// PolygonBatch
+
+	bool PolygonBatch::Add(const Geometry::Polygon& polygon, const Color& color, const Geometry::Camera& camera) NOEXCEPT_IF_NOT_DEBUG {
+		if (polygon.vertices.size() < 3) {
+			THROW_IF_DEBUG("Could not batch polygon: too few vertices");
+			return false;
+		}
+
+		// Fan out from the polygon's first vertex, which is wherever the batch ended before it
+		const int first = static_cast<int>(vertices.size());
+		std::ranges::transform(polygon.vertices, std::back_inserter(vertices), [&](const auto& vertex) {
+			auto screenPoint = Geometry::WorldToScreen(vertex, camera);
+			return SDL_Vertex{ {(float)screenPoint.x, (float)screenPoint.y}, {color.r, color.g, color.b, color.a}, {0.0f, 0.0f} };
+		});
+		for (int i = 1; i < static_cast<int>(polygon.vertices.size()) - 1; ++i) {
+			indices.push_back(first);
+			indices.push_back(first + i);
+			indices.push_back(first + i + 1);
+		}
+		return true;
+	}
+
+	void PolygonBatch::AddScreenQuad(float left, float top, float right, float bottom, const Color& color) {
+		const int first = static_cast<int>(vertices.size());
+		for (const auto& [x, y] : { std::pair{ left, top }, { right, top }, { right, bottom }, { left, bottom } }) {
+			vertices.push_back(SDL_Vertex{ { x, y }, { color.r, color.g, color.b, color.a }, { 0.0f, 0.0f } });
+		}
+		for (int corner : { 0, 1, 2, 0, 2, 3 }) {
+			indices.push_back(first + corner);
+		}
+	}
+
+	void PolygonBatch::AddQuad(const Geometry::Vector2<float>& min, const Geometry::Vector2<float>& max, const Color& color, const Geometry::Camera& camera) {
+		const auto topLeft = Geometry::WorldToScreen(min, camera);
+		const auto bottomRight = Geometry::WorldToScreen(max, camera);
+		AddScreenQuad((float)topLeft.x, (float)topLeft.y, (float)bottomRight.x, (float)bottomRight.y, color);
+	}
+
+	void PolygonBatch::AddPoint(const Geometry::Vector2<float>& point, const Color& color, const Geometry::Camera& camera) {
+		const auto screenPoint = Geometry::WorldToScreen(point, camera);
+		AddScreenQuad((float)screenPoint.x, (float)screenPoint.y, (float)screenPoint.x + 1.0f, (float)screenPoint.y + 1.0f, color);
+	}
+
+	void PolygonBatch::Clear() noexcept {
+		vertices.clear();
+		indices.clear();
+	}
+
 	// Screen
 
 	Screen::Screen() NOEXCEPT_IF_NOT_DEBUG : renderer(window.window) {}
 
+	Screen::Screen(Headless) noexcept : window(nullptr), renderer(nullptr) {}
+
 	Screen::~Screen() noexcept {
 
 		// Notify observers
@@ -127,25 +170,56 @@ namespace SDLWrapper {
 	};
 
 	Screen::Renderer::~Renderer() noexcept {
+		DropStaticLayer();
 		SDL_DestroyRenderer(renderer);
 	}
 
-	Screen::Renderer::Renderer(Renderer&& other) noexcept : renderer(std::exchange(other.renderer, nullptr)) {}
+	Screen::Renderer::Renderer(Renderer&& other) noexcept :
+		renderer(std::exchange(other.renderer, nullptr)),
+		camera(other.camera),
+		vertexBuffer(std::move(other.vertexBuffer)),
+		pointBuffer(std::move(other.pointBuffer)),
+		fanIndices(std::move(other.fanIndices)),
+		staticLayer(std::exchange(other.staticLayer, nullptr)),
+		staticLayerValid(std::exchange(other.staticLayerValid, false)) {}
 
 	Screen::Renderer& Screen::Renderer::operator=(Renderer&& other) noexcept {
+		DropStaticLayer();
 		renderer = std::exchange(other.renderer, nullptr);
+		camera = other.camera;
+		vertexBuffer = std::move(other.vertexBuffer);
+		pointBuffer = std::move(other.pointBuffer);
+		fanIndices = std::move(other.fanIndices);
+		staticLayer = std::exchange(other.staticLayer, nullptr);
+		staticLayerValid = std::exchange(other.staticLayerValid, false);
 		return *this;
 	}
 
+	void Screen::Renderer::ReserveFan(size_t vertexCount) {
+		// Triangle i of the fan is made of the first vertex and vertices i and i + 1
+		for (size_t i = fanIndices.size() / 3 + 1; i < vertexCount - 1; ++i) {
+			fanIndices.push_back(0);
+			fanIndices.push_back(static_cast<int>(i));
+			fanIndices.push_back(static_cast<int>(i + 1));
+		}
+	}
+
+	void Screen::Renderer::SetCamera(const Geometry::Camera& camera) noexcept {
+		this->camera = camera;
+	}
+
+	const Geometry::Camera& Screen::Renderer::GetCamera() const noexcept {
+		return camera;
+	}
+
 	bool Screen::Renderer::RenderLineSequence(const Geometry::LineSequence& lines, const Color& color) NOEXCEPT_IF_NOT_DEBUG {
-		std::vector<SDL_Point> vertexBuffer;
-		vertexBuffer.reserve(lines.vertices.size());
+		pointBuffer.clear();
 		for (auto& vertex : lines.vertices) {
-			auto screenPoint = Geometry::WorldToScreen(vertex);
-			vertexBuffer.push_back(SDL_Point{ screenPoint.x, screenPoint.y });
+			auto screenPoint = Geometry::WorldToScreen(vertex, camera);
+			pointBuffer.push_back(SDL_Point{ screenPoint.x, screenPoint.y });
 		}
 		if ((SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a) ||
-			SDL_RenderDrawLines(renderer, vertexBuffer.data(), (int)vertexBuffer.size()))) {
+			SDL_RenderDrawLines(renderer, pointBuffer.data(), (int)pointBuffer.size()))) {
 			THROW_SDL_ERROR_IF_DEBUG("Could not render lineSequence");
 			return false;
 		}
@@ -159,38 +233,91 @@ namespace SDLWrapper {
 			return false;
 		}
 
-		std::vector<SDL_Vertex> vertexBuffer;
-		vertexBuffer.reserve(polygon.vertices.size());
+		vertexBuffer.clear();
 		std::ranges::transform(polygon.vertices, std::back_inserter(vertexBuffer), [&](const auto& vertex){ 
-			auto screenPoint = Geometry::WorldToScreen(vertex);
-			return SDL_Vertex{ {(float)screenPoint.x, (float)screenPoint.y}, {color.r, color.g, color.b, color.a} };
+			auto screenPoint = Geometry::WorldToScreen(vertex, camera);
+			return SDL_Vertex{ {(float)screenPoint.x, (float)screenPoint.y}, {color.r, color.g, color.b, color.a}, {0.0f, 0.0f} };
 		});
-		/*std::ranges::for_each(polygon.vertices, [&](const auto& vertex) {
-			vertexBuffer.emplace_back(SDL_Vertex{ {(float)screenPoint.x, (float)screenPoint.y}, {color.r, color.g, color.b, color.a} });
-		});*/
+		ReserveFan(vertexBuffer.size());
 
-		std::vector<int> indexBuffer;
-		indexBuffer.reserve(3 * (vertexBuffer.size() - 2));
+		if (SDL_RenderGeometry(renderer, nullptr, vertexBuffer.data(), (int)vertexBuffer.size(),
+			fanIndices.data(), (int)(3 * (vertexBuffer.size() - 2)))) { // Cast to int because that's what SDL expects. So technically, if you create a polygon that requires INT_MAX / 3 triangles, it will underflow and break. But like, that's on you.
+			THROW_SDL_ERROR_IF_DEBUG("Could not render polygon");
+			return false;
+		}
+		return true;
+	}
 
+	bool Screen::Renderer::RenderPolygons(const PolygonBatch& batch) NOEXCEPT_IF_NOT_DEBUG {
+		if (batch.Empty()) {
+			return true;
+		}
+		if (SDL_RenderGeometry(renderer, nullptr, batch.Vertices().data(), (int)batch.Vertices().size(),
+			batch.Indices().data(), (int)batch.Indices().size())) {
+			THROW_SDL_ERROR_IF_DEBUG("Could not render polygon batch");
+			return false;
+		}
+		return true;
+	}
 
-		for (size_t i = 1; i < vertexBuffer.size() - 1; ++i) { // i is the index of the current triangle's second vertex in vertexBuffer
-			indexBuffer.push_back(0);
-			indexBuffer.push_back(static_cast<int>(i));
-			indexBuffer.push_back(static_cast<int>(i + 1));
+	void Screen::Renderer::DropStaticLayer() noexcept {
+		if (staticLayer) {
+			SDL_DestroyTexture(staticLayer);
+			staticLayer = nullptr;
 		}
+		staticLayerValid = false;
+	}
 
-		if (SDL_RenderGeometry(renderer, nullptr, vertexBuffer.data(), (int)vertexBuffer.size(),
-			indexBuffer.data(), (int)indexBuffer.size())) { // Cast to int because that's what SDL expects. So technically, if you create a polygon that requires INT_MAX / 3 triangles, it will underflow and break. But like, that's on you.
-			THROW_SDL_ERROR_IF_DEBUG("Could not render polygon");
+	bool Screen::Renderer::DrawStaticLayer(const PolygonBatch& batch) NOEXCEPT_IF_NOT_DEBUG {
+		if (!staticLayer) {
+			int width, height;
+			if (SDL_GetRendererOutputSize(renderer, &width, &height)) {
+				THROW_SDL_ERROR_IF_DEBUG("Could not get renderer output size");
+				return false;
+			}
+			staticLayer = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+			if (!staticLayer) {
+				THROW_SDL_ERROR_IF_DEBUG("Could not create static layer");
+				return false;
+			}
+			SDL_SetTextureBlendMode(staticLayer, SDL_BLENDMODE_BLEND);
+		}
+
+		// Clear to transparent, so that the layer only covers what it draws
+		if (SDL_SetRenderTarget(renderer, staticLayer)) {
+			THROW_SDL_ERROR_IF_DEBUG("Could not render to static layer");
+			return false;
+		}
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+		SDL_RenderClear(renderer);
+		const bool drawn = RenderPolygons(batch);
+		SDL_SetRenderTarget(renderer, nullptr);
+		staticLayerValid = drawn;
+		return drawn;
+	}
+
+	bool Screen::Renderer::RenderStaticLayer(const PolygonBatch& batch) NOEXCEPT_IF_NOT_DEBUG {
+		if (!SDL_RenderTargetSupported(renderer)) {
+			return RenderPolygons(batch);
+		}
+		if (!staticLayerValid && !DrawStaticLayer(batch)) {
+			return false;
+		}
+		if (SDL_RenderCopy(renderer, staticLayer, nullptr, nullptr)) {
+			THROW_SDL_ERROR_IF_DEBUG("Could not render static layer");
 			return false;
 		}
 		return true;
 	}
 
+	void Screen::Renderer::InvalidateStaticLayer() noexcept {
+		staticLayerValid = false;
+	}
+
 	bool Screen::Renderer::RenderLine(const Geometry::Line& line, const Color& color) NOEXCEPT_IF_NOT_DEBUG {
 		SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-		const auto screenLineA = Geometry::WorldToScreen(line.a);
-		const auto screenLineB = Geometry::WorldToScreen(line.b);
+		const auto screenLineA = Geometry::WorldToScreen(line.a, camera);
+		const auto screenLineB = Geometry::WorldToScreen(line.b, camera);
 		if (SDL_RenderDrawLine(renderer, screenLineA.x, screenLineA.y, screenLineB.x, screenLineB.y)) {
 			THROW_SDL_ERROR_IF_DEBUG("Could not render line");
 			return false;
@@ -200,7 +327,7 @@ namespace SDLWrapper {
 
 	bool Screen::Renderer::RenderPoint(const Geometry::Vector2<float>& point, const Color& color) NOEXCEPT_IF_NOT_DEBUG {
 		SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-		const auto screenPoint = Geometry::WorldToScreen(point);
+		const auto screenPoint = Geometry::WorldToScreen(point, camera);
 		if (SDL_RenderDrawPoint(renderer, screenPoint.x, screenPoint.y)) {
 			THROW_SDL_ERROR_IF_DEBUG("Could not render point");
 			return false;
@@ -238,18 +365,29 @@ namespace SDLWrapper {
 	}
 
 	bool Screen::RenderCurrent() NOEXCEPT_IF_NOT_DEBUG {
+		if (IsHeadless()) {
+			return true;
+		}
 		return renderer.RenderCurrent();
 	}
 
 	void Screen::UpdateTitle(const std::string_view suffix) NOEXCEPT_IF_NOT_DEBUG {
+		if (IsHeadless()) {
+			return;
+		}
 		window.SetTitle(std::string(Constants::APPLICATION_NAME) + ": " + suffix.data());
 	}
 
 	// Mouse
-	[[nodiscard]] Geometry::Vector2<int> Mouse::GetPosition() noexcept {
-		int x, y;
-		SDL_GetMouseState(&x, &y);
-		return { x, y };
+
+	void Mouse::MoveTo(const Geometry::Vector2<int>& position) noexcept {
+		this->position = position;
+	}
+
+	void Mouse::Click(Button button) noexcept {
+		std::for_each(std::execution::unseq, observers.begin(), observers.end(), [button](auto& observer) {
+			observer->OnMouseClicked(button);
+		});
 	}
 
 	void Mouse::SubscribeToClickEvent(BaseMouseClickObserver* observer) noexcept {
@@ -287,6 +425,27 @@ namespace SDLWrapper {
 		return false;
 	}
 
+	bool Keyboard::IsPressed(KeyCode key) const noexcept {
+		return key != KeyCode::NOT_SUPPORTED && key != KeyCode::KEYBOARD_SIZE && keyMap.test(static_cast<size_t>(key));
+	}
+
+	void Keyboard::Press(KeyCode key) noexcept {
+		if (key == KeyCode::NOT_SUPPORTED || key == KeyCode::KEYBOARD_SIZE || keyMap.test(static_cast<size_t>(key))) {
+			return;
+		}
+		keyMap.set(static_cast<size_t>(key));
+		std::for_each(std::execution::unseq, observers.begin(), observers.end(), [key](auto& observer) {
+			observer->OnKeyPressed(key);
+		});
+	}
+
+	void Keyboard::Release(KeyCode key) noexcept {
+		if (key == KeyCode::NOT_SUPPORTED || key == KeyCode::KEYBOARD_SIZE) {
+			return;
+		}
+		keyMap.reset(static_cast<size_t>(key));
+	}
+
 	Keyboard::~Keyboard() noexcept {
 		// Notify observers
 		std::for_each(std::execution::unseq, observers.begin(), observers.end(), [](auto& observer) {
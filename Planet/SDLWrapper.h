@@ -25,6 +25,7 @@ namespace Geometry {
 
 namespace SDLWrapper {
 	
+	// Initializes the video subsystem, along with the events it implies, which is all a window needs. Running headless needs none.
 	int Initialize() NOEXCEPT_IF_NOT_DEBUG;
 
 	// Device declarations for Update function
@@ -40,23 +41,75 @@ namespace SDLWrapper {
 	class BaseKeyPressObserver;
 	class BaseMouseClickObserver;
 
+	// Many polygons triangulated into one vertex and index buffer, so that all of them are drawn with a single call.
+	// Build it when the polygons change, then render it every frame.
+	class PolygonBatch {
+		std::vector<SDL_Vertex> vertices;
+		std::vector<int> indices;
+		void AddScreenQuad(float left, float top, float right, float bottom, const Color& color);
+	public:
+		// Adds polygon as seen through camera. The batch is in screen space, so it must be built again if the camera moves.
+		bool Add(const Geometry::Polygon& polygon, const Color& color, const Geometry::Camera& camera) NOEXCEPT_IF_NOT_DEBUG;
+
+		// Adds the box from min to max, and a single pixel at point, as stand-ins for polygons too small to show any detail
+		void AddQuad(const Geometry::Vector2<float>& min, const Geometry::Vector2<float>& max, const Color& color, const Geometry::Camera& camera);
+		void AddPoint(const Geometry::Vector2<float>& point, const Color& color, const Geometry::Camera& camera);
+
+		// Empties the batch, keeping its memory for the next build
+		void Clear() noexcept;
+		[[nodiscard]] bool Empty() const noexcept { return indices.empty(); }
+		[[nodiscard]] const std::vector<SDL_Vertex>& Vertices() const noexcept { return vertices; }
+		[[nodiscard]] const std::vector<int>& Indices() const noexcept { return indices; }
+	};
+
 	class Screen {
 	public:
 		class Renderer {
 			SDL_Renderer* renderer = nullptr;
 			std::vector<BaseRenderObserver*> observers;
+			Geometry::Camera camera;
 			friend Screen;
 			bool RenderCurrent() NOEXCEPT_IF_NOT_DEBUG;
+
+			// Scratch buffers kept between calls, so that rendering only allocates when a shape is larger than any before it
+			std::vector<SDL_Vertex> vertexBuffer;
+			std::vector<SDL_Point> pointBuffer;
+
+			// The triangle fan indices of the largest polygon rendered so far. A fan over fewer vertices is a prefix of it.
+			std::vector<int> fanIndices;
+			void ReserveFan(size_t vertexCount);
+
+			// A texture the size of the screen holding what rarely changes, which is drawn into only when it is out of date.
+			// Created on first use, and dropped when the device loses it.
+			SDL_Texture* staticLayer = nullptr;
+			bool staticLayerValid = false;
+			friend bool Update(Screen&, Keyboard&, Mouse&) noexcept;
+			void DropStaticLayer() noexcept;
+			bool DrawStaticLayer(const PolygonBatch& batch) NOEXCEPT_IF_NOT_DEBUG;
 		public:
 			Renderer() = delete; // A renderer without a window is undefined
 			Renderer(SDL_Window* window) NOEXCEPT_IF_NOT_DEBUG;
+			explicit Renderer(std::nullptr_t) noexcept {} // Except when headless, where it renders nothing
 			~Renderer() noexcept;
 			Renderer(Renderer&& other) noexcept;
 			Renderer& operator=(Renderer&& other) noexcept;
 			Renderer(const Renderer&) = delete;
 			Renderer& operator=(const Renderer&) = delete;
 
+			// Everything is rendered as seen through the camera, which observers may move before rendering
+			void SetCamera(const Geometry::Camera& camera) noexcept;
+			[[nodiscard]] const Geometry::Camera& GetCamera() const noexcept;
+
 			bool RenderPolygon(const Geometry::Polygon& polygon, const Color& color)         NOEXCEPT_IF_NOT_DEBUG;
+			bool RenderPolygons(const PolygonBatch& batch)                                   NOEXCEPT_IF_NOT_DEBUG;
+
+			// Copies the static layer to the screen, first drawing batch into it if the layer is out of date, so that
+			// a static scene costs the same to render however much of it there is. If the renderer cannot render to
+			// textures, batch is drawn directly instead.
+			bool RenderStaticLayer(const PolygonBatch& batch) NOEXCEPT_IF_NOT_DEBUG;
+
+			// Has the static layer drawn again at the next RenderStaticLayer, for when what it shows has changed
+			void InvalidateStaticLayer() noexcept;
 			bool RenderLineSequence(const Geometry::LineSequence& lines, const Color& color) NOEXCEPT_IF_NOT_DEBUG;
 			bool RenderLine(const Geometry::Line& line, const Color& color)                  NOEXCEPT_IF_NOT_DEBUG;
 			bool RenderPoint(const Geometry::Vector2<float>& point, const Color& color)    NOEXCEPT_IF_NOT_DEBUG;
@@ -67,6 +120,7 @@ namespace SDLWrapper {
 		public:
 			SDL_Window* window = nullptr;
 			Window() NOEXCEPT_IF_NOT_DEBUG;
+			explicit Window(std::nullptr_t) noexcept {}
 			~Window() noexcept;
 			Window(Window&& other) noexcept;
 			Window& operator=(Window&& other) noexcept;
@@ -77,14 +131,23 @@ namespace SDLWrapper {
 		Renderer renderer;
 		// Order is important! window is contructed before renderer, which is dependant on window.
 
+		friend bool Update(Screen&, Keyboard&, Mouse&) noexcept;
+
 	public:
+		// Tags a screen without a window or renderer, for running where there is no display
+		struct Headless {};
+
+		[[nodiscard]] bool IsHeadless() const noexcept { return !window.window; }
+
 		void SubscribeToRenderEvent(BaseRenderObserver* observer) noexcept;
 		bool DetachFromRenderEvent(BaseRenderObserver* observer) noexcept;
 
+		// Neither renders nor notifies observers if headless
 		bool RenderCurrent() NOEXCEPT_IF_NOT_DEBUG;
 		void UpdateTitle(const std::string_view suffix) NOEXCEPT_IF_NOT_DEBUG;
 
 		Screen() NOEXCEPT_IF_NOT_DEBUG;
+		explicit Screen(Headless) noexcept;
 		~Screen() noexcept;
 		Screen(Screen&& other) noexcept;
 		Screen& operator=(Screen&& other) noexcept;
@@ -98,13 +161,19 @@ namespace SDLWrapper {
 
 		friend bool Update(Screen&, Keyboard&, Mouse&) noexcept;
 		std::vector<BaseMouseClickObserver*> observers;
+		Geometry::Vector2<int> position; // In screen space, as of the last motion
 
 	public:
 		enum class Button { LEFT, RIGHT };
-		[[nodiscard]] static Geometry::Vector2<int> GetPosition() noexcept;
+		[[nodiscard]] Geometry::Vector2<int> GetPosition() const noexcept { return position; }
 		void SubscribeToClickEvent(BaseMouseClickObserver* observer) noexcept;
 		bool DetachFromClickEvent(BaseMouseClickObserver* observer) noexcept;
 
+		// Moves the mouse and clicks it just as the user would, notifying observers the same way. Update calls these
+		// for events from SDL, but they may as well be called by a script, or without SDL at all.
+		void MoveTo(const Geometry::Vector2<int>& position) noexcept;
+		void Click(Button button) noexcept;
+
 		// Moves can be default. We only care that observers are not notified, and vector's move clears so our destructor is okay.
 		Mouse() = default;
 		~Mouse() noexcept;
@@ -129,6 +198,14 @@ namespace SDLWrapper {
 
 		void SubscribeToPressEvent(BaseKeyPressObserver* observer) noexcept;
 		bool DetachFromPressEvent(BaseKeyPressObserver* observer) noexcept;
+
+		// Whether key is held down, for input that lasts as long as a key is held rather than happening once per press
+		[[nodiscard]] bool IsPressed(KeyCode key) const noexcept;
+
+		// Presses and releases key just as the user would, notifying observers the same way. Pressing a key that is already
+		// held does nothing, like a key repeat.
+		void Press(KeyCode key) noexcept;
+		void Release(KeyCode key) noexcept;
 	private:
 		friend bool Update(Screen&, Keyboard&, Mouse&) noexcept;
 		std::vector<BaseKeyPressObserver*> observers;
@@ -70,15 +70,20 @@ namespace Geometry {
 			return false;
 		}
 
-		// For the line's normal, does the range of the polygon's mapping contain the mapping of the line?
-		{
-			const auto normal = (line.a - line.b).Normal();
-			const auto [min, max] = std::ranges::minmax(polygon.vertices |
-				std::views::transform([&normal](const auto& vertex) { return Dot(vertex, normal); }));
-			const auto lineMapping = Dot(line.b, normal);
-			if (min > lineMapping - Constants::EPSILON || lineMapping + Constants::EPSILON > max) return false;
-		}
+		// For the line's normal, does the range of the polygon's mapping contain the mapping of the line? And for each edge's?
+		// If every axis maps an overlap, the line and polygon must intersect.
+		return !SeparatedAlongLine(polygon, line) && !SeparatedAlongEdges(polygon, line);
+	}
 
+	[[nodiscard]] bool SeparatedAlongLine(const Polygon& polygon, const Line& line) noexcept {
+		const auto normal = (line.a - line.b).Normal();
+		const auto [min, max] = std::ranges::minmax(polygon.vertices |
+			std::views::transform([&normal](const auto& vertex) { return Dot(vertex, normal); }));
+		const auto lineMapping = Dot(line.b, normal);
+		return min > lineMapping - Constants::EPSILON || lineMapping + Constants::EPSILON > max;
+	}
+
+	[[nodiscard]] bool SeparatedAlongEdges(const Polygon& polygon, const Line& line) noexcept {
 		// For each edge's normal, does the line mapping overlap with the polygon's mapping?
 		for (auto vertexIt = polygon.vertices.begin(); vertexIt != polygon.vertices.end(); ++vertexIt) {
 			
@@ -91,20 +96,69 @@ namespace Geometry {
 				std::views::transform([&normal](const auto& vertex) { return Dot(vertex, normal); }));
 			
 			// Same goes for line
-			const auto [lineMin, lineMax] = std::minmax(Dot(line.a, normal), Dot(line.b, normal));
+			const auto [lineMin, lineMax] = std::minmax({ Dot(line.a, normal), Dot(line.b, normal) });
 
 			// If there is no overlap (given an error of epsilon), the shapes are separated in the normal axis
-			if (polygonMin > lineMax - Constants::EPSILON || lineMin + Constants::EPSILON > polygonMax) return false;
+			if (polygonMin > lineMax - Constants::EPSILON || lineMin + Constants::EPSILON > polygonMax) return true;
 		}
-
-		// All axes map an overlap, so the line and polygon must intersect
-		return true;
+		return false;
 	}
 
 	[[nodiscard]] bool Intersect(const std::vector<Polygon>& world, const Line& line) NOEXCEPT_IF_NOT_DEBUG {
 		return !(world | std::views::filter([&line](const auto& polygon) { return Intersect(polygon, line); })).empty();
 	}
 
+	[[nodiscard]] PolygonFeatures ComputeFeatures(const Polygon& polygon) noexcept {
+		PolygonFeatures features{ polygon.vertices.front(), polygon.vertices.front(), {}, {} };
+		features.normals.reserve(polygon.vertices.size());
+		features.extents.reserve(polygon.vertices.size());
+		for (auto vertexIt = polygon.vertices.begin(); vertexIt != polygon.vertices.end(); ++vertexIt) {
+			features.min = { std::min(features.min.x, vertexIt->x), std::min(features.min.y, vertexIt->y) };
+			features.max = { std::max(features.max.x, vertexIt->x), std::max(features.max.y, vertexIt->y) };
+
+			// Exactly as Intersect(polygon, line) computes them, so that both give the same answers
+			const auto normal = ((std::next(vertexIt) != polygon.vertices.end() ?
+				*std::next(vertexIt) : polygon.vertices.front()) - *vertexIt).Normal();
+			features.normals.push_back(normal);
+			const auto [min, max] = std::ranges::minmax(polygon.vertices |
+				std::views::transform([&normal](const auto& vertex) { return Dot(vertex, normal); }));
+			features.extents.push_back({ min, max });
+		}
+		return features;
+	}
+
+	[[nodiscard]] bool Intersect(const Polygon& polygon, const PolygonFeatures& features, const Line& line) NOEXCEPT_IF_NOT_DEBUG {
+
+		if (polygon.vertices.size() < 3) {
+			THROW_IF_DEBUG("Function Geometry::Intersect was passed a polygon of vertieces.size < 3");
+			return false;
+		}
+
+		// A line outside the bounding box is separated from the polygon along one of the axes below, so this changes no answer
+		if (std::max(line.a.x, line.b.x) < features.min.x || std::min(line.a.x, line.b.x) > features.max.x ||
+			std::max(line.a.y, line.b.y) < features.min.y || std::min(line.a.y, line.b.y) > features.max.y) {
+			return false;
+		}
+
+		if (SeparatedAlongLine(polygon, line)) return false;
+
+		for (size_t edge = 0; edge < features.normals.size(); ++edge) {
+			const auto [polygonMin, polygonMax] = features.extents[edge];
+			const auto [lineMin, lineMax] = std::minmax({ Dot(line.a, features.normals[edge]), Dot(line.b, features.normals[edge]) });
+			if (polygonMin > lineMax - Constants::EPSILON || lineMin + Constants::EPSILON > polygonMax) return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] bool Intersect(const std::vector<Polygon>& world, const std::vector<PolygonFeatures>& features, const Line& line) NOEXCEPT_IF_NOT_DEBUG {
+		for (size_t polygon = 0; polygon < world.size(); ++polygon) {
+			if (Intersect(world[polygon], features[polygon], line)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 	[[nodiscard]] std::vector<Polygon>::const_iterator InPolygon(const std::vector<Polygon>& world, const Vector2<float>& point) NOEXCEPT_IF_NOT_DEBUG {
 		for (auto polyIt = world.begin(); polyIt != world.end(); polyIt++) {
 			if (InPolygon(*polyIt, point)) {
@@ -16,17 +16,43 @@ namespace Geometry {
 
 	struct Polygon {
 		std::vector<Vector2<float>> vertices;
+
+		[[nodiscard]] friend bool operator==(const Polygon&, const Polygon&) = default;
+	};
+
+	// What intersection tests need to know about a polygon, computed once for polygons that are tested over and over
+	struct PolygonFeatures {
+
+		// The bounding box
+		Vector2<float> min, max;
+
+		// The normal of each edge, from each vertex to the next, and the range of the polygon projected onto that normal
+		std::vector<Vector2<float>> normals;
+		std::vector<std::pair<float, float>> extents;
 	};
 
+	[[nodiscard]] PolygonFeatures ComputeFeatures(const Polygon& polygon) noexcept;
+
 	// Returns whether lines lhs and rhs intersect.
 	[[nodiscard]] bool Intersect(const Line& lhs, const Line& rhs) noexcept;
 
 	// Returns whether polygon and line intersect
 	[[nodiscard]] bool Intersect(const Polygon& polygon, const Line& line) NOEXCEPT_IF_NOT_DEBUG;
 
+	// Returns whether polygon lies to one side of the line through line, which is the first and cheapest test of the above.
+	// The polygon must have at least 3 vertices.
+	[[nodiscard]] bool SeparatedAlongLine(const Polygon& polygon, const Line& line) noexcept;
+
+	// Returns whether line lies outside polygon along the normal of any of its edges, which are the rest of the tests
+	[[nodiscard]] bool SeparatedAlongEdges(const Polygon& polygon, const Line& line) noexcept;
+
 	//Returns whether line intersects any polygon in world.
 	[[nodiscard]] bool Intersect(const std::vector<Polygon>& world, const Line& line) NOEXCEPT_IF_NOT_DEBUG;
 
+	// The same tests as above, with the features of each polygon precomputed, which also lets a bounding box rule most polygons out
+	[[nodiscard]] bool Intersect(const Polygon& polygon, const PolygonFeatures& features, const Line& line) NOEXCEPT_IF_NOT_DEBUG;
+	[[nodiscard]] bool Intersect(const std::vector<Polygon>& world, const std::vector<PolygonFeatures>& features, const Line& line) NOEXCEPT_IF_NOT_DEBUG;
+
 	// Returns whether points lies within polygon.
 	[[nodiscard]] bool InPolygon(const Polygon& polygon, const Vector2<float>& point) NOEXCEPT_IF_NOT_DEBUG;
 		
@@ -0,0 +1,87 @@
+#include "ShortestPathMap.h"
+#include <algorithm>
+#include <array>
+
+namespace AStar {
+
+	namespace {
+		// Five samples say little about a large region, so the map is always divided at least this many times
+		constexpr size_t MINIMUM_DEPTH = 4;
+	}
+
+	ShortestPathMap::ShortestPathMap(const std::vector<Geometry::Polygon>& world, const Geometry::Vector2<float>& goal,
+		float resolution, size_t maxRegions) NOEXCEPT_IF_NOT_DEBUG :
+		ShortestPathMap(Geometry::Prepare(Geometry::Publish(world)), goal, resolution, maxRegions) {}
+
+	ShortestPathMap::ShortestPathMap(std::shared_ptr<const Geometry::PreparedWorld> prepared, const Geometry::Vector2<float>& goal,
+		float resolution, size_t maxRegions, std::stop_token stop) NOEXCEPT_IF_NOT_DEBUG : tree(prepared, goal) {
+
+		// The map covers the bounds of the world and the goal, with a margin for agents walking around its outer polygons
+		Geometry::Vector2<float> min = goal, max = goal;
+		for (const auto& features : prepared->features) {
+			min = { std::min(min.x, features.min.x), std::min(min.y, features.min.y) };
+			max = { std::max(max.x, features.max.x), std::max(max.y, features.max.y) };
+		}
+		const Geometry::Vector2<float> margin = { 1.0f, 1.0f };
+		regions.push_back({ min - margin, max + margin, {} });
+
+		// Divide level by level, so that if the regions run out, they run out evenly across the map rather than in its first quadrant
+		std::vector<size_t> depths = { 0 };
+		for (size_t region = 0; region < regions.size() && !stop.stop_requested(); ++region) {
+			const bool uniform = Sample(regions[region]);
+			const auto [min, max] = std::make_pair(regions[region].min, regions[region].max);
+			if ((depths[region] >= MINIMUM_DEPTH && uniform) || (max.x - min.x <= resolution && max.y - min.y <= resolution)
+				|| regions.size() + 4 > maxRegions) {
+				continue;
+			}
+
+			const Geometry::Vector2<float> center = (min + max) * 0.5f;
+			regions[region].subregions = regions.size();
+			regions.push_back({ min, center, {} });
+			regions.push_back({ { center.x, min.y }, { max.x, center.y }, {} });
+			regions.push_back({ { min.x, center.y }, { center.x, max.y }, {} });
+			regions.push_back({ center, max, {} });
+			depths.insert(depths.end(), 4, depths[region] + 1);
+		}
+	}
+
+	bool ShortestPathMap::Sample(Region& region) const NOEXCEPT_IF_NOT_DEBUG {
+		region.samples = {
+			tree.NextWaypoint((region.min + region.max) * 0.5f),
+			tree.NextWaypoint(region.min),
+			tree.NextWaypoint({ region.max.x, region.min.y }),
+			tree.NextWaypoint(region.max),
+			tree.NextWaypoint({ region.min.x, region.max.y })
+		};
+		return std::ranges::all_of(region.samples, [&](size_t sample) { return sample == region.samples.front(); });
+	}
+
+	size_t ShortestPathMap::NextWaypoint(const Geometry::Vector2<float>& position) const NOEXCEPT_IF_NOT_DEBUG {
+		const Region* region = &regions.front();
+		if (position.x < region->min.x || position.y < region->min.y || position.x > region->max.x || position.y > region->max.y) {
+			return tree.NextWaypoint(position);
+		}
+
+		// Subregions are ordered by row, so the quadrant is found from which side of the center the position is on
+		while (region->subregions) {
+			const Geometry::Vector2<float> center = (region->min + region->max) * 0.5f;
+			region = &regions[region->subregions + (position.x >= center.x ? 1 : 0) + (position.y >= center.y ? 2 : 0)];
+		}
+
+		// The label is not trusted over any other waypoint sampled in the region. Going through them from the shortest path
+		// to the longest, the first that is visible is the best of them, so only those shorter than it are tested.
+		std::array<size_t, 5> candidates = region->samples;
+		std::ranges::sort(candidates, std::less{}, [&](size_t waypoint) { return tree.DistanceThrough(position, waypoint); });
+		const auto last = std::ranges::unique(candidates).begin();
+		for (auto candidate = candidates.begin(); candidate != last; ++candidate) {
+			if (tree.Sees(position, *candidate)) {
+				return *candidate;
+			}
+		}
+		return tree.NextWaypoint(position);
+	}
+
+	Geometry::LineSequence ShortestPathMap::FindPath(const Geometry::Vector2<float>& startingPosition) const NOEXCEPT_IF_NOT_DEBUG {
+		return tree.PathThrough(startingPosition, NextWaypoint(startingPosition));
+	}
+}
\ No newline at end of file
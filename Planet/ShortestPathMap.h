@@ -0,0 +1,67 @@
+#pragma once
+
+#include "GoalTree.h"
+#include "Constants.h"
+#include <array>
+#include <stop_token>
+
+namespace AStar {
+
+	// A shortest path map towards a single goal, for when many agents head the same way. Space is divided by a quadtree
+	// into regions which share their first waypoint, found from the shortest path tree rooted at the goal. An agent then
+	// locates its region by descending the tree in O(log n) and follows the waypoint, instead of running its own search.
+	//
+	// The map is approximate. A region is labelled from the waypoints at its corners and center, so an obstacle or a change
+	// of waypoint between those samples goes unnoticed. A lookup therefore weighs every waypoint sampled in its region and
+	// takes the visible one with the shortest path through it, and falls back on the shortest path tree if none is visible.
+	// The path found is never longer than through any of those waypoints, but a waypoint that no sample picked may still be
+	// shorter. The benchmark prints how much longer than the shortest its paths are.
+	//
+	// Only locating the region is O(log n). Each of the up to five waypoints weighed then costs a line of sight test against
+	// the world, and should none of them be visible, the lookup costs a full shortest path tree query on top of those. A
+	// lookup is therefore only cheaper than the tree's when one of the waypoints weighed is visible, as it nearly always is
+	// away from the borders between regions.
+	//
+	// Every sample is a query to the shortest path tree, testing lines to the vertices around it, and regions are
+	// divided along every border between waypoints down to the resolution. Building is therefore far more costly than a
+	// shortest path tree. Regions are divided breadth first, and no further once there are maxRegions of them.
+	// A build may be abandoned by requesting stop, after which it returns as soon as it is done with the region at hand,
+	// leaving a map which is not to be used.
+	class ShortestPathMap {
+
+		struct Region {
+			Geometry::Vector2<float> min, max;
+
+			// The waypoints at the center and the corners of the region, the first of which is its label
+			std::array<size_t, 5> samples;
+
+			// Index of the first of four subregions in regions, or 0 for a leaf. The root is never anyone's subregion.
+			size_t subregions = 0;
+		};
+
+		GoalTree tree;
+		std::vector<Region> regions;
+
+		// Labels a region from its samples, and returns whether they all agree
+		bool Sample(Region& region) const NOEXCEPT_IF_NOT_DEBUG;
+
+	public:
+		ShortestPathMap() = default;
+		ShortestPathMap(const std::vector<Geometry::Polygon>& world, const Geometry::Vector2<float>& goal,
+			float resolution = Constants::SHORTEST_PATH_MAP_RESOLUTION,
+			size_t maxRegions = Constants::SHORTEST_PATH_MAP_MAX_REGIONS) NOEXCEPT_IF_NOT_DEBUG;
+		ShortestPathMap(std::shared_ptr<const Geometry::PreparedWorld> prepared, const Geometry::Vector2<float>& goal,
+			float resolution = Constants::SHORTEST_PATH_MAP_RESOLUTION,
+			size_t maxRegions = Constants::SHORTEST_PATH_MAP_MAX_REGIONS, std::stop_token stop = {}) NOEXCEPT_IF_NOT_DEBUG;
+
+		[[nodiscard]] size_t Version() const noexcept { return tree.Version(); }
+		[[nodiscard]] const Geometry::Vector2<float>& Goal() const noexcept { return tree.Goal(); }
+		[[nodiscard]] size_t RegionCount() const noexcept { return regions.size(); }
+
+		// Returns the first vertex on the path from position to the goal, GOAL if it is visible, or NO_VERTEX if there is no path
+		[[nodiscard]] size_t NextWaypoint(const Geometry::Vector2<float>& position) const NOEXCEPT_IF_NOT_DEBUG;
+
+		// Returns the path from startingPosition to the goal, or an empty sequence if there is none
+		[[nodiscard]] Geometry::LineSequence FindPath(const Geometry::Vector2<float>& startingPosition) const NOEXCEPT_IF_NOT_DEBUG;
+	};
+}
\ No newline at end of file
@@ -1,16 +1,41 @@
 #pragma once
 #include "Constants.h"
+#include <utility>
 
 namespace Geometry {
-	[[nodiscard]] constexpr Vector2<float> ScreenToWorld(const Vector2<int>& screenCoords) {
-		const Vector2<float> scaled = { (float)screenCoords.x / (float)Constants::PIXELS_PER_UNIT.x,
-										(float)screenCoords.y / (float)Constants::PIXELS_PER_UNIT.y };
-		return (scaled - Constants::WORLD_ORIGIN);
+
+	// Where the screen looks into the world: the world position at its centre, and how many times larger than
+	// PIXELS_PER_UNIT things are drawn
+	struct Camera {
+		Vector2<float> center = { 0.0f, 0.0f };
+		float zoom = 1.0f;
+
+		[[nodiscard]] friend constexpr bool operator==(const Camera& lhs, const Camera& rhs) = default;
 	};
 
-	[[nodiscard]] constexpr Vector2<int> WorldToScreen(const Vector2<float>& position) {
-		const Vector2<float> translated = position + Constants::WORLD_ORIGIN;
+	[[nodiscard]] constexpr Vector2<float> ScreenToWorld(const Vector2<int>& screenCoords, const Camera& camera) {
+		const Vector2<float> scaled = { (float)screenCoords.x / ((float)Constants::PIXELS_PER_UNIT.x * camera.zoom),
+										(float)screenCoords.y / ((float)Constants::PIXELS_PER_UNIT.y * camera.zoom) };
+		return scaled - Constants::WORLD_ORIGIN / camera.zoom + camera.center;
+	};
+
+	[[nodiscard]] constexpr Vector2<int> WorldToScreen(const Vector2<float>& position, const Camera& camera) {
+		const Vector2<float> translated = (position - camera.center) * camera.zoom + Constants::WORLD_ORIGIN;
 		return { (int)(translated.x * (float)Constants::PIXELS_PER_UNIT.x),
 			(int)(translated.y * (float)Constants::PIXELS_PER_UNIT.y) };
 	};
+
+	// As above, for a camera which has not moved
+	[[nodiscard]] constexpr Vector2<float> ScreenToWorld(const Vector2<int>& screenCoords) {
+		return ScreenToWorld(screenCoords, Camera{});
+	};
+
+	[[nodiscard]] constexpr Vector2<int> WorldToScreen(const Vector2<float>& position) {
+		return WorldToScreen(position, Camera{});
+	};
+
+	// The corners of the part of the world the camera sees, top left first
+	[[nodiscard]] constexpr std::pair<Vector2<float>, Vector2<float>> Viewport(const Camera& camera) {
+		return { ScreenToWorld({ 0, 0 }, camera), ScreenToWorld(Constants::WINDOW_DIMENSIONS, camera) };
+	}
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+#include <limits>
+#include <cmath>
+
+namespace Geometry {
+
+	namespace {
+		// The most cells a grid has for every polygon in it
+		constexpr size_t CELLS_PER_POLYGON = 4;
+	}
+
+	SpatialGrid::SpatialGrid(const std::vector<Polygon>& polygons, float minimumCellSize) : cellSize(minimumCellSize) {
+		if (polygons.empty()) {
+			return;
+		}
+
+		Vector2<float> end = { -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity() };
+		origin = { std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() };
+		bounds.reserve(polygons.size());
+		for (const auto& polygon : polygons) {
+			auto [minX, maxX] = std::ranges::minmax(polygon.vertices | std::views::transform(&Vector2<float>::x));
+			auto [minY, maxY] = std::ranges::minmax(polygon.vertices | std::views::transform(&Vector2<float>::y));
+			bounds.push_back({ { minX, minY }, { maxX, maxY } });
+			origin = { std::min(origin.x, minX), std::min(origin.y, minY) };
+			end = { std::max(end.x, maxX), std::max(end.y, maxY) };
+		}
+
+		// Polygons spread far apart would otherwise leave most of a fine grid empty
+		const Vector2<float> extent = end - origin;
+		const float sparseCellSize = std::sqrt(extent.x * extent.y / static_cast<float>(CELLS_PER_POLYGON * polygons.size()));
+		cellSize = std::max(minimumCellSize, sparseCellSize);
+		columns = static_cast<size_t>(extent.x / cellSize) + 1;
+		rows = static_cast<size_t>(extent.y / cellSize) + 1;
+
+		// Count the polygons in each cell, then place them, so that every cell's polygons end up next to each other
+		cellStarts.assign(columns * rows + 1, 0);
+		for (const auto& [min, max] : bounds) {
+			auto [firstColumn, firstRow] = CellOf(min);
+			auto [lastColumn, lastRow] = CellOf(max);
+			for (size_t row = firstRow; row <= lastRow; ++row) {
+				for (size_t column = firstColumn; column <= lastColumn; ++column) {
+					++cellStarts[row * columns + column + 1];
+				}
+			}
+		}
+		std::partial_sum(cellStarts.begin(), cellStarts.end(), cellStarts.begin());
+		entries.resize(cellStarts.back());
+		std::vector<size_t> filled(cellStarts.begin(), cellStarts.end() - 1);
+		for (size_t polygon = 0; polygon < bounds.size(); ++polygon) {
+			auto [firstColumn, firstRow] = CellOf(bounds[polygon].first);
+			auto [lastColumn, lastRow] = CellOf(bounds[polygon].second);
+			for (size_t row = firstRow; row <= lastRow; ++row) {
+				for (size_t column = firstColumn; column <= lastColumn; ++column) {
+					entries[filled[row * columns + column]++] = polygon;
+				}
+			}
+		}
+	}
+
+	std::pair<size_t, size_t> SpatialGrid::CellOf(const Vector2<float>& point) const noexcept {
+		const Vector2<float> offset = (point - origin) / cellSize;
+		return { static_cast<size_t>(std::clamp(offset.x, 0.0f, static_cast<float>(columns - 1))),
+			static_cast<size_t>(std::clamp(offset.y, 0.0f, static_cast<float>(rows - 1))) };
+	}
+
+	void SpatialGrid::Query(const Vector2<float>& min, const Vector2<float>& max, std::vector<size_t>& indices) const {
+		if (bounds.empty()) {
+			return;
+		}
+		auto [firstColumn, firstRow] = CellOf(min);
+		auto [lastColumn, lastRow] = CellOf(max);
+		for (size_t row = firstRow; row <= lastRow; ++row) {
+			for (size_t column = firstColumn; column <= lastColumn; ++column) {
+				const size_t cell = row * columns + column;
+				for (size_t entry = cellStarts[cell]; entry < cellStarts[cell + 1]; ++entry) {
+					const size_t polygon = entries[entry];
+					const auto& [polygonMin, polygonMax] = bounds[polygon];
+					if (polygonMax.x < min.x || polygonMin.x > max.x || polygonMax.y < min.y || polygonMin.y > max.y) {
+						continue;
+					}
+
+					// A polygon is in every cell its box overlaps, so only the first of those the query covers reports it
+					auto [polygonColumn, polygonRow] = CellOf(polygonMin);
+					if (std::max(polygonColumn, firstColumn) == column && std::max(polygonRow, firstRow) == row) {
+						indices.push_back(polygon);
+					}
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Shapes.h"
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace Geometry {
+
+	// Buckets polygons by the cells of a uniform grid that their bounding boxes overlap, so that finding the polygons in
+	// a region only looks at the cells it covers instead of at every polygon in the world
+	class SpatialGrid {
+
+		Vector2<float> origin;
+		float cellSize = 1.0f;
+		size_t columns = 0, rows = 0;
+
+		// The bounding box of every polygon
+		std::vector<std::pair<Vector2<float>, Vector2<float>>> bounds;
+
+		// The polygons overlapping cell c are entries[cellStarts[c]] up to entries[cellStarts[c + 1]]
+		std::vector<size_t> cellStarts;
+		std::vector<size_t> entries;
+
+		// The cell containing point, clamped to the grid
+		[[nodiscard]] std::pair<size_t, size_t> CellOf(const Vector2<float>& point) const noexcept;
+
+	public:
+		SpatialGrid() = default;
+
+		// Cells are minimumCellSize wide, or wider in sparse worlds so that the grid has no more than a few cells per polygon
+		SpatialGrid(const std::vector<Polygon>& polygons, float minimumCellSize);
+
+		// Appends the index of every polygon whose bounding box overlaps the box from min to max, each once
+		void Query(const Vector2<float>& min, const Vector2<float>& max, std::vector<size_t>& indices) const;
+
+		[[nodiscard]] size_t PolygonCount() const noexcept { return bounds.size(); }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <unordered_map>
+#include <memory_resource>
+#include <optional>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <climits>
+
+namespace Threading {
+
+	// A hash map split into independently locked shards, so that threads working on different keys rarely wait on each other.
+	// Keys are sharded by the high bits of their hash, which leaves the low bits that pick buckets within a shard spread out.
+	template <typename Key, typename Value, typename Hash = std::hash<Key>, size_t ShardBits = 6>
+	class StripedMap {
+
+		static constexpr size_t SHARD_COUNT = size_t{ 1 } << ShardBits;
+
+		// Each shard gets its own cache line, so that locking one does not slow down the threads using its neighbours
+		struct alignas(64) Shard {
+			std::mutex mutex;
+			std::optional<std::pmr::unordered_map<Key, Value, Hash>> values;
+		};
+
+		std::unique_ptr<Shard[]> shards = std::make_unique<Shard[]>(SHARD_COUNT);
+
+		// Nanoseconds threads have spent waiting for shards that other threads held
+		std::atomic<long long> waited{ 0 };
+
+		[[nodiscard]] Shard& ShardOf(const Key& key) const noexcept {
+			return shards[Hash{}(key) >> (sizeof(size_t) * CHAR_BIT - ShardBits)];
+		}
+
+	public:
+		explicit StripedMap(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+			Reset(resource);
+		}
+
+		// What Lower did with a value
+		enum class Lowering {
+			INSERTED, // There was no value for the key before
+			LOWERED,  // There was a value, but not a lower one
+			KEPT      // There was a lower value, which was kept
+		};
+
+		// Stores value for key unless a lower value is already stored. If Timed, any wait for the shard's lock adds to Waited.
+		template <bool Timed = false>
+		Lowering Lower(const Key& key, const Value& value) {
+			Shard& shard = ShardOf(key);
+			std::unique_lock lock(shard.mutex, std::defer_lock);
+			if constexpr (Timed) {
+				// Only a lock that is taken has to be waited for, and timed, which keeps the clock out of uncontended locking
+				if (!lock.try_lock()) {
+					const auto start = std::chrono::steady_clock::now();
+					lock.lock();
+					waited.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+				}
+			}
+			else {
+				lock.lock();
+			}
+			auto [found, inserted] = shard.values->try_emplace(key, value);
+			if (inserted) {
+				return Lowering::INSERTED;
+			}
+			if (found->second < value) {
+				return Lowering::KEPT;
+			}
+			found->second = value;
+			return Lowering::LOWERED;
+		}
+
+		// How long timed calls to Lower have waited for each other's locks, in total, since the map was last Reset
+		[[nodiscard]] std::chrono::nanoseconds Waited() const noexcept {
+			return std::chrono::nanoseconds(waited.load());
+		}
+
+		// Empties the map and gives all of its memory back, buckets included. The map may not be used again until it is Reset.
+		// Neither may race with Lower.
+		void Release() noexcept {
+			for (size_t shard = 0; shard < SHARD_COUNT; ++shard) {
+				shards[shard].values.reset();
+			}
+		}
+
+		// Empties the map, which then allocates from resource
+		void Reset(std::pmr::memory_resource* resource) {
+			waited = 0;
+			for (size_t shard = 0; shard < SHARD_COUNT; ++shard) {
+				shards[shard].values.emplace(resource);
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "ThreadCountModel.h"
+#include <algorithm>
+
+namespace AStar {
+
+	namespace {
+		// Below this much work, threads cost more in synchronisation than they save
+		constexpr size_t PARALLEL_WORK_THRESHOLD = 4096;
+
+		// How much each new measurement moves an estimate
+		constexpr float SMOOTHING = 0.2f;
+
+		// Every so many choices, a count next to the best is tried instead, in case it has since become better
+		constexpr size_t EXPLORATION_INTERVAL = 8;
+	}
+
+	size_t ThreadCountModel::Work(size_t vertexCount, size_t polygonCount) noexcept {
+		return vertexCount * polygonCount;
+	}
+
+	size_t ThreadCountModel::Choose(size_t work, size_t limit) noexcept {
+		if (limit <= 1 || work < PARALLEL_WORK_THRESHOLD) {
+			return 1;
+		}
+		if (estimates.size() < limit) {
+			estimates.resize(limit);
+		}
+		++choices;
+
+		// Measure one thread and the most allowed before anything else, since those bound what the rest can do
+		if (estimates[0].samples == 0) {
+			return 1;
+		}
+		if (estimates[limit - 1].samples == 0) {
+			return limit;
+		}
+		auto untried = std::find_if(estimates.begin(), estimates.begin() + limit, [](const Estimate& estimate) { return estimate.samples == 0; });
+		if (untried != estimates.begin() + limit) {
+			return untried - estimates.begin() + 1;
+		}
+
+		const size_t best = std::min_element(estimates.begin(), estimates.begin() + limit, [](const Estimate& lhs, const Estimate& rhs) {
+			return lhs.secondsPerWork < rhs.secondsPerWork;
+		}) - estimates.begin() + 1;
+		if (choices % EXPLORATION_INTERVAL == 0) {
+			const bool up = (choices / EXPLORATION_INTERVAL) % 2 == 0;
+			return std::clamp<size_t>(up ? best + 1 : best - 1, 1, limit);
+		}
+		return best;
+	}
+
+	void ThreadCountModel::Record(size_t threadCount, size_t work, std::chrono::duration<float> elapsed) noexcept {
+		if (threadCount == 0 || work < PARALLEL_WORK_THRESHOLD) {
+			return;
+		}
+		if (estimates.size() < threadCount) {
+			estimates.resize(threadCount);
+		}
+		Estimate& estimate = estimates[threadCount - 1];
+		const float measured = elapsed.count() / static_cast<float>(work);
+		estimate.secondsPerWork = estimate.samples == 0 ? measured : estimate.secondsPerWork + SMOOTHING * (measured - estimate.secondsPerWork);
+		++estimate.samples;
+	}
+
+	void ThreadCountModel::Reset() noexcept {
+		estimates.clear();
+		choices = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+
+namespace AStar {
+
+	// Picks how many threads to solve with, from how long recent solves took with each count. Solve times are divided by
+	// the work the world implies, so that measurements from worlds of different sizes can be compared, and kept as
+	// exponentially weighted averages so that the model follows the machine as it warms up or gets busy.
+	// Worlds too small to be worth any synchronisation are always solved by one thread.
+	class ThreadCountModel {
+
+		struct Estimate {
+			float secondsPerWork = 0.0f;
+			size_t samples = 0;
+		};
+
+		// The estimate for solving with n threads is at n - 1
+		std::vector<Estimate> estimates;
+		size_t choices = 0;
+
+	public:
+		// The work of a solve in a world, which is how many vertices each expansion may test against how many polygons
+		[[nodiscard]] static size_t Work(size_t vertexCount, size_t polygonCount) noexcept;
+
+		// Returns a thread count between 1 and limit for a solve of the given work
+		[[nodiscard]] size_t Choose(size_t work, size_t limit) noexcept;
+
+		void Record(size_t threadCount, size_t work, std::chrono::duration<float> elapsed) noexcept;
+
+		// Forgets all measurements, for when the solver changes how it uses its threads
+		void Reset() noexcept;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "ThreadPool.h"
+#include <random>
+
+namespace Threading {
+
+	namespace {
+		thread_local size_t currentWorker = ThreadPool::NOT_A_WORKER;
+	}
+
+	ThreadPool::ThreadPool(size_t workerCount) {
+		workers.reserve(workerCount);
+		for (size_t index = 0; index < workerCount; ++index) {
+			workers.push_back(std::make_unique<Worker>());
+		}
+
+		// Only start the threads once every deque exists, since they may steal from any of them
+		for (size_t index = 0; index < workerCount; ++index) {
+			workers[index]->thread = std::thread([this, index]() { Work(index); });
+		}
+	}
+
+	ThreadPool::~ThreadPool() noexcept {
+		alive = false;
+		wakeSignal.release(static_cast<std::ptrdiff_t>(workers.size()));
+		for (auto& worker : workers) {
+			if (worker->thread.joinable()) {
+				worker->thread.join();
+			}
+		}
+	}
+
+	size_t ThreadPool::CurrentWorker() noexcept {
+		return currentWorker;
+	}
+
+	void ThreadPool::Submit(TaskGroup& group, Task task) {
+		group.pending.fetch_add(1, std::memory_order_relaxed);
+		if (workers.empty()) {
+			// Nobody to hand it to, so run it right away
+			task();
+			group.pending.fetch_sub(1, std::memory_order_release);
+			return;
+		}
+
+		// Workers push onto their own deque, where they will find it first. Everyone else deals tasks out in turn.
+		const size_t target = currentWorker != NOT_A_WORKER ? currentWorker
+			: nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+		{
+			std::lock_guard lock(workers[target]->mutex);
+			workers[target]->tasks.emplace_back(std::move(task), &group);
+		}
+		if (ClaimSleeper()) {
+			wakeSignal.release();
+		}
+	}
+
+	void ThreadPool::Wait(TaskGroup& group) noexcept {
+		const size_t self = currentWorker;
+		while (!group.Done()) {
+			if (!RunOne(self, self == NOT_A_WORKER ? &group : nullptr)) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	// Takes a task from the back of its own deque, or failing that from the front of another's, and runs it. Given only,
+	// takes the oldest task of that group from any deque instead. Returns false if there was no such task anywhere.
+	bool ThreadPool::RunOne(size_t index, const TaskGroup* only) noexcept {
+		std::pair<Task, TaskGroup*> taken;
+		bool found = false;
+
+		if (index != NOT_A_WORKER) {
+			std::lock_guard lock(workers[index]->mutex);
+			if (!workers[index]->tasks.empty()) {
+				taken = std::move(workers[index]->tasks.back());
+				workers[index]->tasks.pop_back();
+				found = true;
+			}
+		}
+
+		if (!found && !workers.empty()) {
+			thread_local std::minstd_rand random(static_cast<unsigned>(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+			const size_t first = random() % workers.size();
+			for (size_t offset = 0; offset < workers.size() && !found; ++offset) {
+				const size_t victim = (first + offset) % workers.size();
+				if (victim == index) {
+					continue;
+				}
+				std::lock_guard lock(workers[victim]->mutex);
+				auto& tasks = workers[victim]->tasks;
+				const auto task = only ? std::ranges::find(tasks, only, &std::pair<Task, TaskGroup*>::second) : tasks.begin();
+				if (task != tasks.end()) {
+					taken = std::move(*task);
+					tasks.erase(task);
+					found = true;
+				}
+			}
+		}
+
+		if (!found) {
+			return false;
+		}
+		taken.first();
+		taken.second->pending.fetch_sub(1, std::memory_order_release);
+		return true;
+	}
+
+	bool ThreadPool::HasWork() noexcept {
+		return std::ranges::any_of(workers, [](auto& worker) {
+			std::lock_guard lock(worker->mutex);
+			return !worker->tasks.empty();
+		});
+	}
+
+	// Takes one parked worker off the count, returning whether there was one to take
+	bool ThreadPool::ClaimSleeper() noexcept {
+		size_t count = sleeping.load();
+		while (count > 0) {
+			if (sleeping.compare_exchange_weak(count, count - 1)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ThreadPool::Work(size_t index) noexcept {
+		currentWorker = index;
+		while (alive) {
+			if (RunOne(index)) {
+				continue;
+			}
+
+			// Announce parking before the last look for work. A submitter either sees the announcement and wakes us, or
+			// pushed before that look and we find its task. If we both act, the spare wake up only costs an extra look.
+			sleeping.fetch_add(1);
+			if (HasWork() && ClaimSleeper()) {
+				continue;
+			}
+			wakeSignal.acquire();
+		}
+	}
+
+	ThreadPool& SharedPool() {
+		static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+		return pool;
+	}
+}
\ No newline at end of file
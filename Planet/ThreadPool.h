@@ -0,0 +1,118 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <semaphore>
+#include <functional>
+#include <algorithm>
+#include <limits>
+#include <exception>
+
+namespace Threading {
+
+	using Task = std::function<void()>;
+
+	// Counts the tasks submitted with it which have not yet completed, so that a caller can wait on just those
+	class TaskGroup {
+		std::atomic<size_t> pending{0};
+		friend class ThreadPool;
+	public:
+		[[nodiscard]] bool Done() const noexcept { return pending.load(std::memory_order_acquire) == 0; }
+	};
+
+	// A work stealing thread pool. Every worker owns a deque of tasks, taking the newest of its own from the back and,
+	// once it runs out, stealing the oldest from the front of a random victim's. Workers which find nothing to steal park
+	// on a semaphore until more work is submitted. Waiting on a group also runs tasks, so tasks may submit and wait on
+	// tasks of their own without starving the pool.
+	class ThreadPool {
+
+		struct Worker {
+			std::mutex mutex;
+			std::deque<std::pair<Task, TaskGroup*>> tasks;
+			std::thread thread;
+		};
+
+		std::vector<std::unique_ptr<Worker>> workers;
+		std::atomic<bool> alive{true};
+
+		// Tasks submitted from outside the pool are handed out in turn
+		std::atomic<size_t> nextWorker{0};
+
+		// Parked workers, and the signal that wakes them
+		std::atomic<size_t> sleeping{0};
+		std::counting_semaphore<> wakeSignal{0};
+
+		void Work(size_t index) noexcept;
+		bool RunOne(size_t index, const TaskGroup* only = nullptr) noexcept;
+		bool HasWork() noexcept;
+		bool ClaimSleeper() noexcept;
+
+	public:
+		static constexpr size_t NOT_A_WORKER = std::numeric_limits<size_t>::max();
+		static constexpr size_t CHUNKS_PER_THREAD = 4;
+
+		explicit ThreadPool(size_t workerCount);
+		~ThreadPool() noexcept;
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		[[nodiscard]] size_t WorkerCount() const noexcept { return workers.size(); }
+
+		// The index of the calling worker, or NOT_A_WORKER if called from a thread outside the pool
+		[[nodiscard]] static size_t CurrentWorker() noexcept;
+
+		void Submit(TaskGroup& group, Task task);
+
+		// Runs tasks until every task in group has completed. A worker runs whatever task it finds, as whichever task it is
+		// in the middle of waits for it anyway. A thread outside the pool only runs tasks of group, so that it is never held
+		// up by, nor holds up, work which has nothing to do with it.
+		void Wait(TaskGroup& group) noexcept;
+
+		// Calls body(first, last) over [0, count) split into chunks of at most grain indices, across the pool and the caller.
+		// If any chunk throws, the first exception is rethrown here once every chunk is done.
+		template <typename Body>
+		void ParallelFor(size_t count, size_t grain, Body&& body) {
+			if (count == 0) {
+				return;
+			}
+			grain = std::max<size_t>(grain, 1);
+			std::mutex failureMutex;
+			std::exception_ptr failure;
+			auto guarded = [&](size_t first) noexcept {
+				try {
+					body(first, std::min(first + grain, count));
+				}
+				catch (...) {
+					std::lock_guard lock(failureMutex);
+					if (!failure) {
+						failure = std::current_exception();
+					}
+				}
+			};
+
+			// Tasks only capture what fits in a std::function without allocating
+			TaskGroup group;
+			for (size_t first = grain; first < count; first += grain) {
+				Submit(group, [&guarded, first]() { guarded(first); });
+			}
+			guarded(0);
+			Wait(group);
+			if (failure) {
+				std::rethrow_exception(failure);
+			}
+		}
+
+		// As above, with a few chunks for every worker and the caller so that stealing can even out chunks that take longer than others
+		template <typename Body>
+		void ParallelFor(size_t count, Body&& body) {
+			ParallelFor(count, count / (CHUNKS_PER_THREAD * (WorkerCount() + 1)), std::forward<Body>(body));
+		}
+	};
+
+	// The pool shared by every parallel stage in the application, with a worker for every core besides the main thread's
+	[[nodiscard]] ThreadPool& SharedPool();
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "VisibilityGraph.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <queue>
+
+namespace Geometry {
+
+	VisibilityGraph::VisibilityGraph(const std::vector<Polygon>& world, Lines lines) NOEXCEPT_IF_NOT_DEBUG :
+		VisibilityGraph(world, ComputeFeatures(world), lines) {}
+
+	VisibilityGraph::VisibilityGraph(const std::vector<Polygon>& world, const std::vector<PolygonFeatures>& features, Lines lines) NOEXCEPT_IF_NOT_DEBUG {
+		Threading::ThreadPool& pool = Threading::SharedPool();
+
+		// Assign every vertex an id, in the order they appear in the world, and remember which polygon each belongs to
+		std::vector<size_t> polygonOf, firstOf;
+		for (size_t polygon = 0; polygon < world.size(); ++polygon) {
+			firstOf.push_back(vertices.size());
+			for (const auto& vertex : world[polygon].vertices) {
+				ids.emplace(vertex, vertices.size());
+				vertices.push_back(vertex);
+				polygonOf.push_back(polygon);
+			}
+		}
+		edges.resize(vertices.size());
+
+		// The visible angular extrema of every other polygon, as seen from each vertex. This is where nearly all the time goes,
+		// and every vertex only writes its own list, so the vertices are simply split between the threads.
+		std::vector<std::vector<size_t>> extrema(vertices.size());
+		pool.ParallelFor(vertices.size(), [&](size_t first, size_t last) {
+			for (size_t id = first; id < last; ++id) {
+				for (size_t other = 0; other < world.size(); ++other) {
+					if (other == polygonOf[id]) {
+						continue;
+					}
+					const auto& [leftMost, rightMost] = GetAnglularExtrema(world[other], vertices[id]);
+					if (!Intersect(world, features, { vertices[id], leftMost })) {
+						extrema[id].push_back(ids.at(leftMost));
+					}
+					if (!Intersect(world, features, { vertices[id], rightMost })) {
+						extrema[id].push_back(ids.at(rightMost));
+					}
+				}
+				std::ranges::sort(extrema[id]);
+			}
+		});
+
+		// A shortest path only bends around the vertices it passes, so a line between two polygons is only part of one
+		// if it is tangent to both. That is when each end is an angular extremum as seen from the other.
+		// Each vertex gathers its own edges, so both ends of an edge add it independently.
+		pool.ParallelFor(vertices.size(), [&](size_t first, size_t last) {
+			for (size_t from = first; from < last; ++from) {
+				auto connect = [&](size_t to) {
+					edges[from].push_back({ to, (vertices[to] - vertices[from]).Magnitude() });
+				};
+
+				// The neighbouring vertices in the same polygon
+				const size_t polygonFirst = firstOf[polygonOf[from]];
+				const size_t count = world[polygonOf[from]].vertices.size();
+				const size_t index = from - polygonFirst;
+				connect(polygonFirst + (index + count - 1) % count);
+				connect(polygonFirst + (index + 1) % count);
+
+				for (size_t to : extrema[from]) {
+					if (lines == Lines::EXTREMUM || std::ranges::binary_search(extrema[to], from)) {
+						connect(to);
+					}
+				}
+			}
+		});
+
+		// Keeping every extremum, the lines where only one end is an extremum are still edges at both ends.
+		// The other end only learns of them here, one vertex at a time, as any vertex may add to any other's edges.
+		if (lines == Lines::EXTREMUM) {
+			for (size_t from = 0; from < vertices.size(); ++from) {
+				for (size_t to : extrema[from]) {
+					if (!std::ranges::binary_search(extrema[to], from)) {
+						edges[to].push_back({ from, (vertices[to] - vertices[from]).Magnitude() });
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<PolygonFeatures> ComputeFeatures(const std::vector<Polygon>& world) NOEXCEPT_IF_NOT_DEBUG {
+		std::vector<PolygonFeatures> features(world.size());
+		Threading::SharedPool().ParallelFor(world.size(), [&](size_t first, size_t last) {
+			for (size_t polygon = first; polygon < last; ++polygon) {
+				features[polygon] = ComputeFeatures(world[polygon]);
+			}
+		});
+		return features;
+	}
+
+	std::optional<size_t> VisibilityGraph::IdOf(const Vector2<float>& position) const noexcept {
+		auto found = ids.find(position);
+		if (found == ids.end()) {
+			return {};
+		}
+		return found->second;
+	}
+
+	std::vector<VisibilityGraph::Edge> VisibleVertices(const std::vector<Polygon>& world,
+		const VisibilityGraph& graph, const Vector2<float>& point) NOEXCEPT_IF_NOT_DEBUG {
+
+		if (auto id = graph.IdOf(point)) {
+			return graph.edges[*id];
+		}
+
+		std::vector<VisibilityGraph::Edge> visible;
+		for (const auto& polygon : world) {
+			const auto& [leftMost, rightMost] = GetAnglularExtrema(polygon, point);
+			if (!Intersect(world, { point, leftMost })) {
+				visible.push_back({ graph.ids.at(leftMost), (leftMost - point).Magnitude() });
+			}
+			if (!Intersect(world, { point, rightMost })) {
+				visible.push_back({ graph.ids.at(rightMost), (rightMost - point).Magnitude() });
+			}
+		}
+		return visible;
+	}
+
+	ShortestPathTree ShortestPaths(const VisibilityGraph& graph, const std::vector<VisibilityGraph::Edge>& sources) noexcept {
+		ShortestPathTree tree{
+			std::vector<float>(graph.vertices.size(), std::numeric_limits<float>::infinity()),
+			std::vector<size_t>(graph.vertices.size(), VisibilityGraph::NO_VERTEX)
+		};
+
+		// Entries are (distance, vertex), and a vertex may be queued several times. Only its shortest entry is expanded.
+		using Entry = std::pair<float, size_t>;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> fringe;
+		for (const auto& source : sources) {
+			if (source.length < tree.distances[source.to]) {
+				tree.distances[source.to] = source.length;
+				fringe.push({ source.length, source.to });
+			}
+		}
+
+		while (!fringe.empty()) {
+			const auto [distance, vertex] = fringe.top();
+			fringe.pop();
+			if (distance > tree.distances[vertex]) {
+				continue;
+			}
+			for (const auto& edge : graph.edges[vertex]) {
+				if (distance + edge.length < tree.distances[edge.to]) {
+					tree.distances[edge.to] = distance + edge.length;
+					tree.parents[edge.to] = vertex;
+					fringe.push({ tree.distances[edge.to], edge.to });
+				}
+			}
+		}
+		return tree;
+	}
+}
\ No newline at end of file
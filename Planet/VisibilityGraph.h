@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Shapes.h"
+#include <unordered_map>
+#include <optional>
+#include <limits>
+
+namespace Geometry {
+
+	// Hashes a vector by its components, so that world vertices can be looked up by their position
+	struct Vector2Hash {
+		[[nodiscard]] size_t operator()(const Vector2<float>& vector) const noexcept {
+			return std::hash<float>{}(vector.x) ^ (std::hash<float>{}(vector.y) << 1);
+		}
+	};
+
+	// An undirected graph over every vertex in a world. Two vertices are connected if they neighbour each other in a polygon,
+	// or if each is a visible angular extremum of the other's view. These are the edges the A* solver discovers that can
+	// be part of a shortest path, so the shortest path between two vertices in this graph is also their shortest path in the world.
+	struct VisibilityGraph {
+
+		static constexpr size_t NO_VERTEX = std::numeric_limits<size_t>::max();
+
+		// Which lines between vertices of different polygons are edges
+		enum class Lines {
+			BITANGENT, // Those where each end is an angular extremum of the other's view, as above
+			EXTREMUM   // Those where either end is, which are all the lines the A* solver follows, whether they can be part of a shortest path or not
+		};
+
+		struct Edge {
+			size_t to;
+			float length;
+		};
+
+		std::vector<Vector2<float>> vertices;
+		std::vector<std::vector<Edge>> edges;
+		std::unordered_map<Vector2<float>, size_t, Vector2Hash> ids;
+
+		VisibilityGraph() = default;
+		explicit VisibilityGraph(const std::vector<Polygon>& world, Lines lines = Lines::BITANGENT) NOEXCEPT_IF_NOT_DEBUG;
+
+		// Builds the graph from the precomputed features of every polygon in world, with the vertices spread over the shared thread pool
+		VisibilityGraph(const std::vector<Polygon>& world, const std::vector<PolygonFeatures>& features,
+			Lines lines = Lines::BITANGENT) NOEXCEPT_IF_NOT_DEBUG;
+
+		// Returns the id of the vertex at position, if there is one
+		[[nodiscard]] std::optional<size_t> IdOf(const Vector2<float>& position) const noexcept;
+	};
+
+	// Computes the features of every polygon in world across the shared thread pool
+	[[nodiscard]] std::vector<PolygonFeatures> ComputeFeatures(const std::vector<Polygon>& world) NOEXCEPT_IF_NOT_DEBUG;
+
+	// Returns an edge to every vertex that the A* solver would discover from point.
+	// If point is itself a vertex of the graph, these are simply its edges.
+	[[nodiscard]] std::vector<VisibilityGraph::Edge> VisibleVertices(const std::vector<Polygon>& world,
+		const VisibilityGraph& graph, const Vector2<float>& point) NOEXCEPT_IF_NOT_DEBUG;
+
+	// Shortest distances from a set of sources to every vertex, and the vertex each path arrives from.
+	// Unreachable vertices have an infinite distance, and sources have NO_VERTEX as parent.
+	struct ShortestPathTree {
+		std::vector<float> distances;
+		std::vector<size_t> parents;
+	};
+
+	// Runs Dijkstra's algorithm over graph. Each source is given as an edge to the vertex the search starts from,
+	// whose length is the distance the search starts with, so that points which are not vertices can act as the source.
+	[[nodiscard]] ShortestPathTree ShortestPaths(const VisibilityGraph& graph, const std::vector<VisibilityGraph::Edge>& sources) noexcept;
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#include "World.h"
+#include <atomic>
+
+namespace Geometry {
+
+	World Publish(std::vector<Polygon> polygons) {
+		static std::atomic<size_t> nextVersion{0};
+		return std::make_shared<const WorldSnapshot>(WorldSnapshot{ nextVersion++, std::move(polygons) });
+	}
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Shapes.h"
+#include <memory>
+
+namespace Geometry {
+
+	// One version of the world, which is never modified once published. Editing the world publishes a new snapshot instead,
+	// so whoever holds an older one keeps a consistent view of it without copying or locking, and anything derived from
+	// a snapshot can be cached by its version.
+	struct WorldSnapshot {
+		size_t version;
+		std::vector<Polygon> polygons;
+	};
+	using World = std::shared_ptr<const WorldSnapshot>;
+
+	// Publishes polygons as a snapshot, with a version no other snapshot has
+	[[nodiscard]] World Publish(std::vector<Polygon> polygons);
+
+	// Publishes a copy of world with edit applied to its polygons
+	template <typename Edit>
+	[[nodiscard]] World Modify(const World& world, Edit&& edit) {
+		std::vector<Polygon> polygons = world->polygons;
+		edit(polygons);
+		return Publish(std::move(polygons));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,404 @@
+#include "WorldGenerator.h"
+#include "SpatialGrid.h"
+#include "Constants.h"
+#include <algorithm>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <ranges>
+#include <cmath>
+
+namespace Geometry {
+
+	namespace {
+
+		// The standard distributions may differ between standard libraries, so numbers are drawn straight from the engine,
+		// which does not
+		class Random {
+			std::mt19937 engine;
+		public:
+			explicit Random(uint32_t seed) : engine(seed) {}
+
+			// In [min, max)
+			float Uniform(float min, float max) noexcept {
+				return min + (max - min) * static_cast<float>(engine() >> 8) * 0x1.0p-24f;
+			}
+
+			// In [0, count)
+			size_t Index(size_t count) noexcept {
+				return static_cast<size_t>(engine() % count);
+			}
+		};
+
+		// A convex polygon of vertexCount vertices on the ellipse about center with the given radii, turned by orientation.
+		// Points on a circle in order of their angle are always convex, and so are they once stretched and turned, so the
+		// angles only need to stay in order however they are jittered.
+		Polygon EllipseVertices(Random& random, const Vector2<float>& center, float radius, float minorRadius, float orientation, size_t vertexCount) {
+			const float step = 2.0f * std::numbers::pi_v<float> / static_cast<float>(vertexCount);
+			const float rotation = random.Uniform(0.0f, step);
+			const float cosine = std::cos(orientation), sine = std::sin(orientation);
+			Polygon polygon;
+			polygon.vertices.reserve(vertexCount);
+			for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
+				const float angle = rotation + step * (static_cast<float>(vertex) + random.Uniform(-0.3f, 0.3f));
+				const Vector2<float> unturned{ std::cos(angle) * radius, std::sin(angle) * minorRadius };
+				polygon.vertices.push_back(center + Vector2<float>{ unturned.x * cosine - unturned.y * sine, unturned.x * sine + unturned.y * cosine });
+			}
+			return polygon;
+		}
+
+		Polygon CircleVertices(Random& random, const Vector2<float>& center, float radius, size_t vertexCount) {
+			return EllipseVertices(random, center, radius, radius, 0.0f, vertexCount);
+		}
+
+		Polygon Rectangle(const Vector2<float>& min, const Vector2<float>& max) {
+			return Polygon{ { min, { max.x, min.y }, max, { min.x, max.y } } };
+		}
+
+		std::vector<Polygon> Scatter(const WorldParameters& parameters, Random& random) {
+			const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(parameters.polygonCount))));
+			const size_t rows = (parameters.polygonCount + columns - 1) / columns;
+			const Vector2<float> origin = Vector2<float>{ static_cast<float>(columns), static_cast<float>(rows) } * (-0.5f * parameters.cellSize);
+			const size_t vertexCount = std::max<size_t>(parameters.vertexCount, 3);
+
+			// A regular polygon of radius r has an area of n / 2 * r^2 * sin(2pi / n). What room is left in the cell is jitter,
+			// keeping a margin to the edges so that polygons in neighbouring cells never touch.
+			const float area = std::clamp(parameters.density, 0.0f, 1.0f) * parameters.cellSize * parameters.cellSize;
+			const float regularArea = 0.5f * static_cast<float>(vertexCount) * std::sin(2.0f * std::numbers::pi_v<float> / static_cast<float>(vertexCount));
+			const float maxRadius = 0.45f * parameters.cellSize;
+			const float radius = std::min(std::sqrt(area / regularArea), maxRadius);
+			const float jitter = maxRadius - radius;
+
+			std::vector<Polygon> polygons;
+			polygons.reserve(parameters.polygonCount);
+			for (size_t index = 0; index < parameters.polygonCount; ++index) {
+				const Vector2<float> cellCenter = origin + Vector2<float>{ static_cast<float>(index % columns) + 0.5f,
+					static_cast<float>(index / columns) + 0.5f } * parameters.cellSize;
+				const Vector2<float> center = cellCenter + Vector2<float>{ random.Uniform(-jitter, jitter), random.Uniform(-jitter, jitter) } * std::numbers::sqrt2_v<float> * 0.5f;
+				polygons.push_back(CircleVertices(random, center, radius, vertexCount));
+			}
+			return polygons;
+		}
+
+		// Corridors are carved the same way, except that the walk rather goes on the way it came
+		std::vector<Polygon> Maze(const WorldParameters& parameters, Random& random, bool corridors) {
+			// Carving a perfect maze knocks down one wall for every cell but the first, which leaves about one wall per cell. In
+			// a maze, about two walls run straight on into one another, and in corridors about four, which is one rectangle.
+			const size_t cellCount = std::max<size_t>(parameters.polygonCount * (corridors ? 4 : 2), 1);
+			const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(cellCount))));
+			const size_t rows = (cellCount + columns - 1) / columns;
+			const float size = parameters.cellSize;
+			const float thickness = std::clamp(parameters.density, 0.02f, 0.9f) * size * 0.5f;
+			const Vector2<float> origin = Vector2<float>{ static_cast<float>(columns), static_cast<float>(rows) } * (-0.5f * size);
+
+			// Carve a perfect maze by a random depth first walk, knocking down the walls it walks through. Every cell has
+			// the wall to its right and the wall below it, and the grid is closed off by walls along its top and left.
+			std::vector<bool> rightWall(columns * rows, true), bottomWall(columns * rows, true), visited(columns * rows, false);
+			std::vector<size_t> stack{ 0 };
+			visited[0] = true;
+			while (!stack.empty()) {
+				const size_t cell = stack.back();
+				const size_t column = cell % columns, row = cell / columns;
+				size_t neighbours[4], neighbourCount = 0;
+				if (column > 0 && !visited[cell - 1]) neighbours[neighbourCount++] = cell - 1;
+				if (column + 1 < columns && !visited[cell + 1]) neighbours[neighbourCount++] = cell + 1;
+				if (row > 0 && !visited[cell - columns]) neighbours[neighbourCount++] = cell - columns;
+				if (row + 1 < rows && !visited[cell + columns]) neighbours[neighbourCount++] = cell + columns;
+				if (neighbourCount == 0) {
+					stack.pop_back();
+					continue;
+				}
+				size_t next = 0;
+				const size_t straight = stack.size() > 1 ? 2 * cell - stack[stack.size() - 2] : cell;
+				if (corridors && std::ranges::find(neighbours, neighbours + neighbourCount, straight) != neighbours + neighbourCount &&
+					random.Uniform(0.0f, 1.0f) < 0.8f) {
+					next = straight;
+				}
+				else {
+					next = neighbours[random.Index(neighbourCount)];
+				}
+				if (next == cell + 1) rightWall[cell] = false;
+				else if (next + 1 == cell) rightWall[next] = false;
+				else if (next == cell + columns) bottomWall[cell] = false;
+				else bottomWall[next] = false;
+				visited[next] = true;
+				stack.push_back(next);
+			}
+
+			// Lay the walls out by the grid lines they lie on, the horizontal ones on line 0 to rows and the vertical ones on
+			// line 0 to columns
+			std::vector<bool> horizontalWalls((rows + 1) * columns), verticalWalls(rows * (columns + 1));
+			for (size_t column = 0; column < columns; ++column) {
+				horizontalWalls[column] = true;
+			}
+			for (size_t row = 0; row < rows; ++row) {
+				verticalWalls[row * (columns + 1)] = true;
+			}
+			for (size_t cell = 0; cell < columns * rows; ++cell) {
+				const size_t column = cell % columns, row = cell / columns;
+				horizontalWalls[(row + 1) * columns + column] = bottomWall[cell];
+				verticalWalls[row * (columns + 1) + column + 1] = rightWall[cell];
+			}
+			auto horizontalAt = [&](size_t column, size_t line) {
+				return column < columns && horizontalWalls[line * columns + column];
+			};
+			auto verticalAt = [&](size_t line, size_t row) {
+				return row < rows && line <= columns && verticalWalls[row * (columns + 1) + line];
+			};
+
+			// The search takes polygons that neither overlap nor touch, so walls cannot meet. Vertical walls run on through the
+			// corners they meet other walls at, while horizontal walls stop a little short of them, which leaves narrow gaps
+			// at those corners for paths to squeeze through. Every other straight run of walls is one rectangle, with no gaps.
+			const float half = 0.5f * thickness, gap = 0.25f * half;
+			std::vector<Polygon> polygons;
+			for (size_t line = 0; line <= rows; ++line) {
+				auto metByVertical = [&](size_t junction) { return verticalAt(junction, line - 1) || verticalAt(junction, line); };
+				auto inset = [&](size_t junction) { return metByVertical(junction) ? half + gap : -half; };
+				for (size_t column = 0; column < columns;) {
+					if (!horizontalAt(column, line)) {
+						++column;
+						continue;
+					}
+					size_t end = column + 1;
+					while (horizontalAt(end, line) && !metByVertical(end)) {
+						++end;
+					}
+					const Vector2<float> start = origin + Vector2<float>{ static_cast<float>(column), static_cast<float>(line) } * size;
+					const float length = static_cast<float>(end - column) * size;
+					polygons.push_back(Rectangle(start + Vector2<float>{ inset(column), -half }, start + Vector2<float>{ length - inset(end), half }));
+					column = end;
+				}
+			}
+			for (size_t line = 0; line <= columns; ++line) {
+				for (size_t row = 0; row < rows;) {
+					if (!verticalAt(line, row)) {
+						++row;
+						continue;
+					}
+					size_t end = row + 1;
+					while (verticalAt(line, end)) {
+						++end;
+					}
+					const Vector2<float> start = origin + Vector2<float>{ static_cast<float>(line), static_cast<float>(row) } * size;
+					const float length = static_cast<float>(end - row) * size;
+					polygons.push_back(Rectangle(start + Vector2<float>{ -half, -half }, start + Vector2<float>{ half, length + half }));
+					row = end;
+				}
+			}
+			return polygons;
+		}
+
+		std::vector<Polygon> Poisson(const WorldParameters& parameters, Random& random) {
+			// Bridson's algorithm. Each sample tries a few times to place another in the ring from one to two spacings around
+			// it, and is retired once every try lands too close to some other sample. The samples are found by a grid of cells
+			// too small to hold two of them, so that each try only looks at the cells around it.
+			const float spacing = 0.8f * parameters.cellSize;
+			const float side = std::sqrt(static_cast<float>(parameters.polygonCount)) * parameters.cellSize;
+			const float gridCell = spacing / std::numbers::sqrt2_v<float>;
+			const size_t gridSide = std::max<size_t>(static_cast<size_t>(std::ceil(side / gridCell)), 1);
+			constexpr size_t EMPTY = std::numeric_limits<size_t>::max();
+			constexpr size_t ATTEMPTS = 30;
+			std::vector<size_t> grid(gridSide * gridSide, EMPTY), active;
+			std::vector<Vector2<float>> centers;
+			auto gridIndex = [&](float coordinate) { return std::min(static_cast<size_t>(coordinate / gridCell), gridSide - 1); };
+			auto place = [&](const Vector2<float>& center) {
+				grid[gridIndex(center.y) * gridSide + gridIndex(center.x)] = centers.size();
+				active.push_back(centers.size());
+				centers.push_back(center);
+			};
+			place({ random.Uniform(0.0f, side), random.Uniform(0.0f, side) });
+			while (!active.empty() && centers.size() < parameters.polygonCount) {
+				const size_t activeIndex = random.Index(active.size());
+				const Vector2<float> from = centers[active[activeIndex]];
+				bool placed = false;
+				for (size_t attempt = 0; attempt < ATTEMPTS && !placed; ++attempt) {
+					const float angle = random.Uniform(0.0f, 2.0f * std::numbers::pi_v<float>);
+					const float distance = random.Uniform(spacing, 2.0f * spacing);
+					const Vector2<float> candidate = from + Vector2<float>{ std::cos(angle), std::sin(angle) } * distance;
+					if (candidate.x < 0.0f || candidate.y < 0.0f || candidate.x >= side || candidate.y >= side) {
+						continue;
+					}
+					const size_t column = gridIndex(candidate.x), row = gridIndex(candidate.y);
+					bool clear = true;
+					for (size_t y = row > 1 ? row - 2 : 0; y <= std::min(row + 2, gridSide - 1) && clear; ++y) {
+						for (size_t x = column > 1 ? column - 2 : 0; x <= std::min(column + 2, gridSide - 1) && clear; ++x) {
+							const size_t other = grid[y * gridSide + x];
+							clear = other == EMPTY || (centers[other] - candidate).MagnitudeSqr() >= spacing * spacing;
+						}
+					}
+					if (clear) {
+						place(candidate);
+						placed = true;
+					}
+				}
+				if (!placed) {
+					active[activeIndex] = active.back();
+					active.pop_back();
+				}
+			}
+
+			// Sized like scattered polygons, then shrunk by up to a half, and never so large that two could meet
+			const size_t vertexCount = std::max<size_t>(parameters.vertexCount, 3);
+			const float area = std::clamp(parameters.density, 0.0f, 1.0f) * parameters.cellSize * parameters.cellSize;
+			const float regularArea = 0.5f * static_cast<float>(vertexCount) * std::sin(2.0f * std::numbers::pi_v<float> / static_cast<float>(vertexCount));
+			const float radius = std::min(std::sqrt(area / regularArea), 0.45f * spacing);
+			const Vector2<float> origin{ -0.5f * side, -0.5f * side };
+			std::vector<Polygon> polygons;
+			polygons.reserve(centers.size());
+			for (const Vector2<float>& center : centers) {
+				polygons.push_back(CircleVertices(random, origin + center, radius * random.Uniform(0.5f, 1.0f), vertexCount));
+			}
+			return polygons;
+		}
+
+		std::vector<Polygon> Clusters(const WorldParameters& parameters, Random& random) {
+			// Up to five by five polygons to a cluster, each a quarter of a cell across with a tenth of that between them
+			const size_t clusterSide = std::min<size_t>(static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(parameters.polygonCount)))), 5);
+			const size_t perCluster = clusterSide * clusterSide;
+			const size_t clusterCount = (parameters.polygonCount + perCluster - 1) / perCluster;
+			const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(clusterCount))));
+			const size_t rows = (clusterCount + columns - 1) / columns;
+			const float small = 0.25f * parameters.cellSize;
+			const float clusterSize = static_cast<float>(clusterSide) * small;
+			const float spacing = std::max(clusterSize / std::sqrt(std::clamp(parameters.density, 0.01f, 1.0f)), clusterSize + small);
+			const float jitter = 0.5f * (spacing - clusterSize - small);
+			const Vector2<float> origin = Vector2<float>{ static_cast<float>(columns), static_cast<float>(rows) } * (-0.5f * spacing);
+			const size_t vertexCount = std::max<size_t>(parameters.vertexCount, 3);
+
+			std::vector<Polygon> polygons;
+			polygons.reserve(parameters.polygonCount);
+			Vector2<float> clusterCorner;
+			for (size_t index = 0; index < parameters.polygonCount; ++index) {
+				const size_t cluster = index / perCluster, member = index % perCluster;
+				if (member == 0) {
+					const Vector2<float> clusterCenter = origin + Vector2<float>{ static_cast<float>(cluster % columns) + 0.5f,
+						static_cast<float>(cluster / columns) + 0.5f } * spacing;
+					clusterCorner = clusterCenter + Vector2<float>{ random.Uniform(-jitter, jitter), random.Uniform(-jitter, jitter) } - Vector2<float>{ 0.5f * clusterSize, 0.5f * clusterSize };
+				}
+				const Vector2<float> center = clusterCorner + Vector2<float>{ static_cast<float>(member % clusterSide) + 0.5f,
+					static_cast<float>(member / clusterSide) + 0.5f } * small;
+				polygons.push_back(CircleVertices(random, center, 0.45f * small * random.Uniform(0.8f, 1.0f), vertexCount));
+			}
+			return polygons;
+		}
+
+		std::vector<Polygon> Slivers(const WorldParameters& parameters, Random& random) {
+			// Ellipses thirty times as long as they are wide, each within the circle that a scattered polygon is kept inside.
+			// Along the long sides of one with many vertices, the vertices are so nearly in line that rounding their
+			// coordinates would bend the sides inwards, so they get no more than MAX_SLIVER_VERTICES.
+			constexpr size_t MAX_SLIVER_VERTICES = 32;
+			const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(parameters.polygonCount))));
+			const size_t rows = (parameters.polygonCount + columns - 1) / columns;
+			const Vector2<float> origin = Vector2<float>{ static_cast<float>(columns), static_cast<float>(rows) } * (-0.5f * parameters.cellSize);
+			const size_t vertexCount = std::clamp<size_t>(parameters.vertexCount, 3, MAX_SLIVER_VERTICES);
+			const float maxRadius = 0.45f * parameters.cellSize;
+
+			std::vector<Polygon> polygons;
+			polygons.reserve(parameters.polygonCount);
+			for (size_t index = 0; index < parameters.polygonCount; ++index) {
+				const Vector2<float> cellCenter = origin + Vector2<float>{ static_cast<float>(index % columns) + 0.5f,
+					static_cast<float>(index / columns) + 0.5f } * parameters.cellSize;
+				const float radius = maxRadius * random.Uniform(0.7f, 1.0f);
+				const float jitter = 0.5f * (maxRadius - radius);
+				const Vector2<float> center = cellCenter + Vector2<float>{ random.Uniform(-jitter, jitter), random.Uniform(-jitter, jitter) };
+				const float orientation = random.Uniform(0.0f, std::numbers::pi_v<float>);
+				polygons.push_back(EllipseVertices(random, center, radius, radius / 30.0f, orientation, vertexCount));
+			}
+			return polygons;
+		}
+
+		std::vector<Polygon> Collinear(const WorldParameters& parameters, Random& random) {
+			// Each polygon has a flat bottom along the line of its row, put off the line by less than EPSILON, which is as far as
+			// the intersection tests forgive, and on top an arc a tenth as high as it is wide. The polygons are moved off the line
+			// whole, since tilting their bottoms by that much would bend the ends of the arcs the wrong way.
+			const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(parameters.polygonCount))));
+			const size_t rows = (parameters.polygonCount + columns - 1) / columns;
+			const float size = parameters.cellSize;
+			const Vector2<float> origin = Vector2<float>{ static_cast<float>(columns), static_cast<float>(rows) } * (-0.5f * size);
+			const size_t arcVertexCount = std::max<size_t>(parameters.vertexCount, 3) - 2;
+			const float halfWidth = 0.4f * size, height = 0.08f * size;
+
+			std::vector<Polygon> polygons;
+			polygons.reserve(parameters.polygonCount);
+			for (size_t index = 0; index < parameters.polygonCount; ++index) {
+				const float center = origin.x + (static_cast<float>(index % columns) + 0.5f) * size;
+				const float line = origin.y + (static_cast<float>(index / columns) + 0.75f) * size + random.Uniform(-0.5f, 0.5f) * Constants::EPSILON;
+				Polygon polygon;
+				polygon.vertices.reserve(arcVertexCount + 2);
+				polygon.vertices.push_back({ center - halfWidth, line });
+				polygon.vertices.push_back({ center + halfWidth, line });
+				for (size_t vertex = 1; vertex <= arcVertexCount; ++vertex) {
+					const float t = 1.0f - 2.0f * static_cast<float>(vertex) / static_cast<float>(arcVertexCount + 1);
+					polygon.vertices.push_back({ center + t * halfWidth, line - height * (1.0f - t * t) });
+				}
+				polygons.push_back(std::move(polygon));
+			}
+			return polygons;
+		}
+	}
+
+	std::vector<Polygon> GenerateWorld(const WorldParameters& parameters) {
+		Random random(parameters.seed);
+		if (parameters.polygonCount == 0) {
+			return {};
+		}
+		switch (parameters.layout) {
+		case WorldParameters::Layout::MAZE:
+			return Maze(parameters, random, false);
+		case WorldParameters::Layout::POISSON:
+			return Poisson(parameters, random);
+		case WorldParameters::Layout::CORRIDORS:
+			return Maze(parameters, random, true);
+		case WorldParameters::Layout::CLUSTERS:
+			return Clusters(parameters, random);
+		case WorldParameters::Layout::SLIVERS:
+			return Slivers(parameters, random);
+		case WorldParameters::Layout::COLLINEAR:
+			return Collinear(parameters, random);
+		default:
+			return Scatter(parameters, random);
+		}
+	}
+
+	const char* LayoutName(WorldParameters::Layout layout) noexcept {
+		switch (layout) {
+		case WorldParameters::Layout::MAZE:      return "maze";
+		case WorldParameters::Layout::POISSON:   return "poisson";
+		case WorldParameters::Layout::CORRIDORS: return "corridors";
+		case WorldParameters::Layout::CLUSTERS:  return "clusters";
+		case WorldParameters::Layout::SLIVERS:   return "slivers";
+		case WorldParameters::Layout::COLLINEAR: return "collinear";
+		default:                                 return "scatter";
+		}
+	}
+
+	std::vector<Vector2<float>> GenerateFreePositions(const std::vector<Polygon>& world, size_t count, uint32_t seed) {
+		if (world.empty()) {
+			return std::vector<Vector2<float>>(count);
+		}
+		Vector2<float> min = world.front().vertices.front(), max = min;
+		for (const Polygon& polygon : world) {
+			for (const Vector2<float>& vertex : polygon.vertices) {
+				min = { std::min(min.x, vertex.x), std::min(min.y, vertex.y) };
+				max = { std::max(max.x, vertex.x), std::max(max.y, vertex.y) };
+			}
+		}
+
+		// Only the polygons whose bounding boxes hold a candidate need testing. Worlds too dense to have any room left
+		// take as many tries as it takes to find some.
+		Random random(seed);
+		const SpatialGrid grid(world, 1.0f);
+		std::vector<size_t> nearby;
+		std::vector<Vector2<float>> positions;
+		positions.reserve(count);
+		while (positions.size() < count) {
+			const Vector2<float> candidate{ random.Uniform(min.x, max.x), random.Uniform(min.y, max.y) };
+			nearby.clear();
+			grid.Query(candidate, candidate, nearby);
+			if (std::ranges::none_of(nearby, [&](size_t index) { return InPolygon(world[index], candidate); })) {
+				positions.push_back(candidate);
+			}
+		}
+		return positions;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Shapes.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Geometry {
+
+	// Parameters of a generated world. The same parameters always generate the same world, on any platform.
+	struct WorldParameters {
+		enum class Layout {
+			SCATTER,   // Polygons jittered about a grid, at most one to a cell
+			MAZE,      // The walls of a maze, one rectangle to each straight run of walls, with narrow gaps where walls meet
+			POISSON,   // Polygons of different sizes at random, though never closer than a cell apart, as Poisson disc sampling places them
+			CORRIDORS, // A maze carved to rather go straight, which leaves long corridors between long walls
+			CLUSTERS,  // Tight groups of small polygons with narrow gaps between them, and open space between the groups
+			SLIVERS,   // Polygons many times longer than they are wide, turned every which way, one to a cell
+			COLLINEAR, // Rows of shallow polygons whose flat sides lie within EPSILON of one line, topped by nearly straight arcs
+			LAYOUT_COUNT
+		} layout = Layout::SCATTER;
+
+		// Roughly how many polygons there are. Mazes and corridors get as many cells as make about that many straight walls.
+		size_t polygonCount = 64;
+
+		// How many vertices each polygon has, except walls, which have four, and slivers, which have at most 32
+		size_t vertexCount = 6;
+
+		// How much of the world the polygons cover, from 0 to 1. In a maze, how much of each cell its walls take up, and
+		// among clusters, how much of the world the clusters take up. Slivers and the polygons of clusters are as large as fits.
+		float density = 0.3f;
+
+		// The side of the grid cells, in world space units
+		float cellSize = 0.8f;
+
+		uint32_t seed = 0;
+	};
+
+	// Generates a world of convex polygons centred on the origin, none of which overlap or touch, as the search requires
+	[[nodiscard]] std::vector<Polygon> GenerateWorld(const WorldParameters& parameters);
+
+	// The name of layout in lower case, as in "corridors"
+	[[nodiscard]] const char* LayoutName(WorldParameters::Layout layout) noexcept;
+
+	// Generates count positions within the bounds of world and outside all of its polygons, for paths to start and end at
+	[[nodiscard]] std::vector<Vector2<float>> GenerateFreePositions(const std::vector<Polygon>& world, size_t count, uint32_t seed);
+}
\ No newline at end of file
@@ -1,13 +1,55 @@
 // C++20 or newer
 
 #include "Application.h"
+#include "InputScript.h"
+#include <fstream>
+#include <string_view>
+#include <cstdio>
 
 // If in debug mode, the application is wrapped in a try/catch block.
 // It is mostly noexcept if in release mode, so that it runs faster.
 
-int main() {
+// Loads the input script at path, in either form, or prints why not
+std::optional<SDLWrapper::InputScript> LoadScript(const char* path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		std::fprintf(stderr, "Could not open input script %s\n", path);
+		return std::nullopt;
+	}
+	std::optional<SDLWrapper::InputScript> script = SDLWrapper::InputScript::Load(file);
+	if (!script) {
+		std::fprintf(stderr, "Could not read input script %s\n", path);
+	}
+	return script;
+}
 
-	TRY_IF_DEBUG;
+// Runs the input script at path without a window, stepping the application as fast as it goes, and prints how long it took.
+// For servers without a display, and for benchmarks.
+int RunHeadless(const char* path) {
+	const std::optional<SDLWrapper::InputScript> script = LoadScript(path);
+	if (!script) {
+		return 1;
+	}
+
+	SDLWrapper::Screen screen(SDLWrapper::Screen::Headless{});
+	SDLWrapper::Keyboard keyboard;
+	SDLWrapper::Mouse mouse;
+	Application application(screen, keyboard, mouse, Application::Stepping::MANUAL);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t step = 0; step < script->Length(); ++step) {
+		script->Apply(step, keyboard, mouse);
+		application.SampleInput();
+		application.Advance();
+	}
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	std::printf("%zu steps in %.3f ms\n", script->Length(), elapsed.count());
+	return 0;
+}
+
+// Runs the application in a window. If replay is passed, it is played back in real time on top of the user's input,
+// and if recordPath is, the session is recorded there when the window closes.
+int RunWindowed(const SDLWrapper::InputScript* replay, const char* recordPath) {
 
 	// Initialize everything
 
@@ -16,27 +58,64 @@ int main() {
 	SDLWrapper::Keyboard keyboard;
 	SDLWrapper::Mouse mouse;
 	Application application(screen, keyboard, mouse);
+	if (recordPath) {
+		application.StartRecording();
+	}
 
-	auto currentTime = std::chrono::steady_clock::now();
-	// Program loop. Update SDL, handle input and render.
+	// Program loop. Update SDL, sample input and render. The application simulates on a thread of its own.
+	size_t replayedSteps = 0;
 	while (true) {
 
 		if (!SDLWrapper::Update(screen, keyboard, mouse)) {
 			break;
 		};
 
-		auto deltaTime = std::chrono::steady_clock::now() - currentTime;
-		currentTime = std::chrono::steady_clock::now();
+		// Play back the steps the simulation has reached. Each is handled by the first step after, which in real time
+		// is not always the step it was recorded at, so only headless replay is exact.
+		if (replay) {
+			for (const size_t stepCount = application.StepCount(); replayedSteps <= stepCount; ++replayedSteps) {
+				replay->Apply(replayedSteps, keyboard, mouse);
+			}
+		}
 
-		if (!application.Update(deltaTime))
-			break;
+		application.SampleInput();
 
 		if (!screen.RenderCurrent())
 			break;
 
 	}
 
+	if (recordPath) {
+		std::ofstream file(recordPath, std::ios::binary);
+		if (!file || !application.StopRecording().Save(file)) {
+			std::fprintf(stderr, "Could not save recording to %s\n", recordPath);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// Run as "Planet --headless script" to play back a script or recording without a window, see InputScript.h,
+// "Planet --replay script" to play it back in a window, or "Planet --record file" to record the session into file.
+int main(int argc, char* argv[]) {
+
+	int returnCode = 1;
+	TRY_IF_DEBUG;
+
+	const std::string_view option = argc == 3 ? argv[1] : "";
+	if (option == "--headless") {
+		returnCode = RunHeadless(argv[2]);
+	}
+	else if (option == "--replay") {
+		if (const std::optional<SDLWrapper::InputScript> script = LoadScript(argv[2])) {
+			returnCode = RunWindowed(&*script, nullptr);
+		}
+	}
+	else {
+		returnCode = RunWindowed(nullptr, option == "--record" ? argv[2] : nullptr);
+	}
+
 	CATCH_IF_DEBUG;
 
-	return 0;
+	return returnCode;
 }
\ No newline at end of file